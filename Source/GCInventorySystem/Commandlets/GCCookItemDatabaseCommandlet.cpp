@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCCookItemDatabaseCommandlet.h"
+#include "Engine/GCCookedItemDatabase.h"
+#include "Modules/GCInventorySystem.h"
+#include "Subsystems/GCInventoryGISSubsystems.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GCCookItemDatabaseCommandlet)
+
+UGCCookItemDatabaseCommandlet::UGCCookItemDatabaseCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UGCCookItemDatabaseCommandlet::Main(const FString& params)
+{
+	const auto inventorySettings = GetDefault<UGCInventoryGISSubsystems>();
+
+	FString filename;
+	if (!FParse::Value(*params, TEXT("Output="), filename))
+	{
+		filename = inventorySettings->GetCookedItemDatabaseFilename();
+	}
+
+	const auto dataAsset = inventorySettings->GetItemsDataAsset().LoadSynchronous();
+
+	if (!dataAsset)
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to find ItemsDataAsset. Please set it in the inventory settings."), ANSI_TO_TCHAR(__FUNCTION__));
+		return 1;
+	}
+
+	return FGCCookedItemDatabase::Write(*dataAsset, filename) ? 0 : 1;
+}
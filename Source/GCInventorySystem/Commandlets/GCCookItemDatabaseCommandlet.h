@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "GCCookItemDatabaseCommandlet.generated.h"
+
+/**
+ *  Bakes the items data asset set in the inventory settings into the cooked item database.
+ *  Usage: UnrealEditor-Cmd.exe <Project> -run=GCCookItemDatabase [-Output=<File>]
+ */
+UCLASS()
+class UGCCookItemDatabaseCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UGCCookItemDatabaseCommandlet();
+
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& params) override;
+	// End UCommandlet Interface
+};
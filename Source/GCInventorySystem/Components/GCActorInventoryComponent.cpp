@@ -1,14 +1,50 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "GCActorInventoryComponent.h"
+#include "GCCraftingContext.h"
 #include "Interfaces/GCInventoryInterface.h"
 #include "Subsystems/GCInventoryGISSubsystems.h"
+#include "Subsystems/GCInventoryEventSubsystem.h"
+#include "Subsystems/GCCraftingSchedulerSubsystem.h"
+#include "Modules/GCInventorySystem.h"
 #include <Net/UnrealNetwork.h>
+#include <Net/Core/PushModel/PushModel.h>
+#include <Misc/CoreDelegates.h>
+#include <GameFramework/GameStateBase.h>
 
 DEFINE_LOG_CATEGORY(LogGCActorInventoryComponent);
 
+DECLARE_CYCLE_STAT(TEXT("Inventory ApplyInventoryDelta"), STAT_GCInventory_ApplyInventoryDelta, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("Inventory CraftItem"), STAT_GCInventory_CraftItem, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("Inventory CraftItemBatch"), STAT_GCInventory_CraftItemBatch, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("Inventory ConsumeItemRecipe"), STAT_GCInventory_ConsumeItemRecipe, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("Inventory CanItemBeCrafted"), STAT_GCInventory_CanItemBeCrafted, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("Inventory FindMaxCraftableAmount"), STAT_GCInventory_FindMaxCraftableAmount, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("Inventory PlanItemCraft"), STAT_GCInventory_PlanItemCraft, STATGROUP_GCInventory);
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GCActorInventoryComponent)
 
+namespace GCActorInventoryComponent
+{
+	enum EInventoryEventFlags : uint8
+	{
+		ItemGrantedEvent = 1 << 0,
+		ItemUsedEvent = 1 << 1,
+		ItemRemovedEvent = 1 << 2,
+		ItemDroppedEvent = 1 << 3,
+		AllItemsDroppedEvent = 1 << 4,
+		ItemCraftedEvent = 1 << 5,
+		ItemRecipeConsumedEvent = 1 << 6,
+	};
+
+	// A blueprint override of an event lives in the generated class, so the event is native while a native class still owns its function
+	bool IsEventNative(const UClass* ownerClass, const FName& eventName)
+	{
+		const auto eventFunction = ownerClass->FindFunctionByName(eventName);
+		return eventFunction && eventFunction->GetOwnerClass()->HasAnyClassFlags(CLASS_Native);
+	}
+}
+
 UGCActorInventoryComponent::UGCActorInventoryComponent(const FObjectInitializer& ObjectInitializer)
 {
 	HeldItemTags = FGCGameplayTagStackContainer();
@@ -18,10 +54,79 @@ UGCActorInventoryComponent::UGCActorInventoryComponent(const FObjectInitializer&
 	PrimaryComponentTick.bCanEverTick = false;
 }
 
+void UGCActorInventoryComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	CacheInventoryInterface();
+
+	HeldItemTags.OnTagStackDirty.BindUObject(this, &ThisClass::HandleHeldItemStackDirty);
+	HeldItemTags.OnReplicatedReceive.BindUObject(this, &ThisClass::HandleHeldItemsReplicatedReceive);
+	HeldItemTags.OnStacksReplicated.RemoveAll(this);
+	HeldItemTags.OnStacksReplicated.AddUObject(this, &ThisClass::HandleHeldItemsReplicated);
+	HeldItemTags.SetDeferReplicatedChanges(bDeferReplicatedChangesToEndOfFrame);
+
+	HeldItemTags.SetInitialSyncChunkSize(InitialSyncChunkSize);
+	HeldItemTags.SetJournalCapacity(HeldItemsJournalCapacity);
+	HeldItemTags.SetReceivesReplicatedStacks(GetNetMode() == NM_Client);
+	PublicHeldItemTags.SetReceivesReplicatedStacks(GetNetMode() == NM_Client);
+
+	if (InitialSyncPriorityTags.Num() > 0)
+	{
+		HeldItemTags.SetInitialSyncPriority([priorityTags = InitialSyncPriorityTags](const FGameplayTag& itemTag)
+			{
+				const int32 priority = priorityTags.IndexOfByPredicate([&itemTag](const FGameplayTag& priorityTag)
+					{
+						return itemTag.MatchesTag(priorityTag);
+					});
+
+				return priority != INDEX_NONE ? priority : priorityTags.Num();
+			});
+	}
+}
+
+void UGCActorInventoryComponent::OnUnregister()
+{
+	if (EndOfFrameFlushHandle.IsValid())
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndOfFrameFlushHandle);
+		EndOfFrameFlushHandle.Reset();
+	}
+
+	InventoryInterfaceOwner = nullptr;
+	NativeInventoryInterface = nullptr;
+	bOwnerImplementsInventoryInterface = false;
+	NativeInventoryEvents = 0;
+
+	Super::OnUnregister();
+}
+
 void UGCActorInventoryComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		UpdateNumHeldItemStacks();
+	}
+
+	if (bUseDenseItemStorage)
+	{
+		// item ids are only known once the items database is ready
+		if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(this))
+		{
+			inventorySubsystem->CallOrRegister_OnItemsDatabaseReady(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &ThisClass::EnableDenseItemStorage));
+		}
+	}
+
+	if (bTrackCraftableRecipes)
+	{
+		if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(this))
+		{
+			inventorySubsystem->CallOrRegister_OnItemsDatabaseReady(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &ThisClass::EnableCraftableRecipesTracking));
+		}
+	}
+
 	if (StartUpItems.Num() > 0)
 	{
 		for (const auto& currentItem : StartUpItems)
@@ -31,24 +136,66 @@ void UGCActorInventoryComponent::BeginPlay()
 	}
 }
 
+void UGCActorInventoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (const auto craftingScheduler = UGCCraftingSchedulerSubsystem::Get(this))
+	{
+		craftingScheduler->RemoveInventoryJobs(this);
+	}
+
+	// the deferred events of the inventory would otherwise be dropped with it
+	if (bDeferItemEvents)
+	{
+		if (const auto eventSubsystem = UGCInventoryEventSubsystem::Get(this))
+		{
+			eventSubsystem->FlushItemEvents(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UGCActorInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ThisClass, HeldItemTags);
+	// inventories change rarely, so they are only compared once their container pushed them dirty
+	FDoRepLifetimeParams heldItemsParams;
+	heldItemsParams.bIsPushBased = true;
+	heldItemsParams.Condition = ReplicationMode == EGCInventoryReplicationMode::AllConnections ? COND_None : COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, HeldItemTags, heldItemsParams);
+
+	FDoRepLifetimeParams publicItemsParams;
+	publicItemsParams.bIsPushBased = true;
+	publicItemsParams.Condition = ReplicationMode == EGCInventoryReplicationMode::OwnerWithPublicSubset ? COND_SkipOwner : COND_Never;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, PublicHeldItemTags, publicItemsParams);
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, NumHeldItemStacks, heldItemsParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, CraftingJobs, heldItemsParams);
+}
+
+void UGCActorInventoryComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// keep the held items dirty until every connection received all the chunks
+	if (HeldItemTags.ConsumePendingInitialSync())
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, HeldItemTags, this);
+	}
 }
 
 bool UGCActorInventoryComponent::AddItemToInventory(FGameplayTag itemTag, float itemStack)
 {
-	const auto ownerActor = GetOwner();
+	const auto ownerActor = GetInventoryInterfaceOwner();
 
-	if (ownerActor && ownerActor->GetClass()->ImplementsInterface(UGCInventoryInterface::StaticClass()))
+	if (ownerActor)
 	{
 		HeldItemTags.AddStack(itemTag, itemStack);
 
-		IGCInventoryInterface::Execute_ItemGranted(ownerActor, itemTag, itemStack);
+		NotifyItemGranted(ownerActor, itemTag, itemStack);
 
-		OnItemGranted.Broadcast(itemTag, itemStack, ownerActor);
+		BroadcastItemEvent(EGCInventoryItemEventType::Granted, itemTag, itemStack);
 
 		return true;
 	}
@@ -58,72 +205,125 @@ bool UGCActorInventoryComponent::AddItemToInventory(FGameplayTag itemTag, float
 
 void UGCActorInventoryComponent::UseItemFromInventory(FGameplayTag itemTag, float itemStack)
 {
-	const auto ownerActor = GetOwner();
+	const auto ownerActor = GetInventoryInterfaceOwner();
 
-	if (ownerActor && ownerActor->GetClass()->ImplementsInterface(UGCInventoryInterface::StaticClass()) && IsItemInInventory(itemTag))
+	if (ownerActor && IsItemInInventory(itemTag))
 	{
-		IGCInventoryInterface::Execute_ItemUsed(ownerActor, itemTag, itemStack);
+		NotifyItemUsed(ownerActor, itemTag, itemStack);
 
-		OnItemUsed.Broadcast(itemTag, itemStack, ownerActor);
+		BroadcastItemEvent(EGCInventoryItemEventType::Used, itemTag, itemStack);
 	}
 }
 
 void UGCActorInventoryComponent::DropItemFromInventory(FGameplayTag itemTag, float itemStack)
 {
-	const auto ownerActor = GetOwner();
+	const auto ownerActor = GetInventoryInterfaceOwner();
 
-	if (ownerActor && ownerActor->GetClass()->ImplementsInterface(UGCInventoryInterface::StaticClass()) && ContainsItemInInventory(itemTag, itemStack))
+	if (ownerActor && ContainsItemInInventory(itemTag, itemStack))
 	{
 		HeldItemTags.RemoveStack(itemTag, itemStack);
 
-		IGCInventoryInterface::Execute_ItemDropped(ownerActor, itemTag, itemStack);
+		NotifyItemDropped(ownerActor, itemTag, itemStack);
 
-		OnItemRemoved.Broadcast(itemTag, itemStack, ownerActor);
+		BroadcastItemEvent(EGCInventoryItemEventType::Removed, itemTag, itemStack);
 	}
 }
 
 void UGCActorInventoryComponent::DropAllItemsFromInventory()
 {
-	const auto copiedHeldItems = HeldItemTags.GetGameplayTagStackList();
+	const auto heldItems = HeldItemTags.GetStacksView();
 
-	if (copiedHeldItems.Num() > 0)
+	if (heldItems.Num() > 0)
 	{
-		for (const auto& itemStack : copiedHeldItems)
+		FGCInventoryDelta dropDelta;
+		dropDelta.RemovalType = EGCInventoryRemovalType::Dropped;
+		dropDelta.ItemsToRemove.Reserve(heldItems.Num());
+
+		for (const auto& itemStack : heldItems)
 		{
-			DropItemFromInventory(itemStack.GetGameplayTag(), itemStack.GetStackCount());
+			dropDelta.ItemsToRemove.Add(itemStack.GetGameplayTag(), itemStack.GetStackCount());
 		}
 
-		IGCInventoryInterface::Execute_AllItemsDropped(GetOwner());
+		if (ApplyInventoryDelta(dropDelta))
+		{
+			NotifyAllItemsDropped(GetOwner());
 
-		OnDropAllItemsFromInventoryDelegate.Broadcast();
+			OnDropAllItemsFromInventoryDelegate.Broadcast();
+		}
 	}
 }
 
 void UGCActorInventoryComponent::RemoveItemFromInventory(FGameplayTag itemTag, float itemStack)
 {
-	const auto ownerActor = GetOwner();
+	const auto ownerActor = GetInventoryInterfaceOwner();
 
-	if (ownerActor && ownerActor->GetClass()->ImplementsInterface(UGCInventoryInterface::StaticClass()) && IsItemInInventory(itemTag))
+	if (ownerActor && IsItemInInventory(itemTag))
 	{
 		HeldItemTags.RemoveStack(itemTag, itemStack);
 
-		IGCInventoryInterface::Execute_ItemRemoved(ownerActor, itemTag, itemStack);
+		NotifyItemRemoved(ownerActor, itemTag, itemStack);
 
-		OnItemRemoved.Broadcast(itemTag, itemStack, ownerActor);
+		BroadcastItemEvent(EGCInventoryItemEventType::Removed, itemTag, itemStack);
 	}
 }
 
 void UGCActorInventoryComponent::RemoveAllItemsFromInventory()
 {
-	const auto copiedHeldItems = HeldItemTags.GetGameplayTagStackList();
+	const auto heldItems = HeldItemTags.GetStacksView();
+
+	if (heldItems.Num() > 0)
+	{
+		FGCInventoryDelta removeDelta;
+		removeDelta.ItemsToRemove.Reserve(heldItems.Num());
+
+		for (const auto& itemStack : heldItems)
+		{
+			removeDelta.ItemsToRemove.Add(itemStack.GetGameplayTag(), itemStack.GetStackCount());
+		}
+
+		ApplyInventoryDelta(removeDelta);
+	}
+}
+
+bool UGCActorInventoryComponent::ApplyInventoryDelta(const FGCInventoryDelta& delta)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_ApplyInventoryDelta);
+	CSV_SCOPED_TIMING_STAT(GCInventory, ApplyInventoryDelta);
+
+	const auto ownerActor = GetInventoryInterfaceOwner();
+
+	if (!ownerActor || !IsInventoryDeltaValid(delta))
+	{
+		return false;
+	}
+
+	HeldItemTags.ApplyStackDelta(delta.ItemsToRemove, delta.ItemsToAdd);
 
-	if (copiedHeldItems.Num() > 0)
+	// notify once the inventory holds the final state so listeners never observe a partially applied delta
+	for (const auto& removedItem : delta.ItemsToRemove)
 	{
-		for (const auto& itemStack : copiedHeldItems)
+		if (delta.RemovalType == EGCInventoryRemovalType::Dropped)
 		{
-			RemoveItemFromInventory(itemStack.GetGameplayTag(), itemStack.GetStackCount());
+			NotifyItemDropped(ownerActor, removedItem.Key, removedItem.Value);
 		}
+		else
+		{
+			NotifyItemRemoved(ownerActor, removedItem.Key, removedItem.Value);
+		}
+
+		BroadcastItemEvent(EGCInventoryItemEventType::Removed, removedItem.Key, removedItem.Value);
+	}
+
+	for (const auto& addedItem : delta.ItemsToAdd)
+	{
+		NotifyItemGranted(ownerActor, addedItem.Key, addedItem.Value);
+
+		BroadcastItemEvent(EGCInventoryItemEventType::Granted, addedItem.Key, addedItem.Value);
 	}
+
+	OnInventoryDeltaApplied.Broadcast(delta, ownerActor);
+
+	return true;
 }
 
 void UGCActorInventoryComponent::ClearInventory()
@@ -146,83 +346,192 @@ float UGCActorInventoryComponent::GetItemStack(FGameplayTag itemTag) const
 	return HeldItemTags.GetStackCount(itemTag);
 }
 
-TMap<FGameplayTag, float> UGCActorInventoryComponent::GetAllItemsOnInventory() const
+const TMap<FGameplayTag, float>& UGCActorInventoryComponent::GetAllItemsOnInventory() const
 {
-	TMap<FGameplayTag, float> currentItemsMap;
-
-	const auto& currentItemsArray = HeldItemTags.GetGameplayTagStackList();
+	const int32 inventoryVersion = HeldItemTags.GetVersion();
 
-	if (currentItemsArray.Num() > 0)
+	if (ItemsSnapshotVersion != inventoryVersion)
 	{
-		for (const auto& itemStack : currentItemsArray)
+		const auto heldItems = HeldItemTags.GetStacksView();
+
+		// Reset keeps the allocation, so rebuilding an inventory of a similar size does not allocate
+		ItemsSnapshot.Reset();
+		ItemsSnapshot.Reserve(heldItems.Num());
+
+		for (const auto& itemStack : heldItems)
 		{
-			currentItemsMap.Add(itemStack.GetGameplayTag(), itemStack.GetStackCount());
+			ItemsSnapshot.Add(itemStack.GetGameplayTag(), itemStack.GetStackCount());
 		}
+
+		ItemsSnapshotVersion = inventoryVersion;
 	}
 
-	return currentItemsMap;
+	return ItemsSnapshot;
 }
 
 float UGCActorInventoryComponent::GetTotalAmountItems() const
 {
-	float total = 0.0f;
+	return HeldItemTags.GetTotalStackCount();
+}
+
+int32 UGCActorInventoryComponent::GetInventoryVersion() const
+{
+	return HeldItemTags.GetVersion();
+}
 
-	const auto& items = HeldItemTags.GetGameplayTagStackList();
+void UGCActorInventoryComponent::GetInventoryChangesSince(int32 sinceVersion, FGCTagStackDiff& outDiff) const
+{
+	HeldItemTags.GetChangesSince(sinceVersion, outDiff);
+}
 
-	for (const auto& itemStack : items)
+float UGCActorInventoryComponent::GetPublicItemStack(FGameplayTag itemTag) const
+{
+	if (ReplicationMode != EGCInventoryReplicationMode::OwnerWithPublicSubset)
 	{
-		total += itemStack.GetStackCount();
+		return GetItemStack(itemTag);
 	}
 
-	return total;
+	// the owner and the server hold every item, the other clients only receive the public ones
+	return IsPublicItem(itemTag) ? FMath::Max(HeldItemTags.GetStackCount(itemTag), PublicHeldItemTags.GetStackCount(itemTag)) : 0.f;
+}
+
+bool UGCActorInventoryComponent::IsInventoryFullySynced() const
+{
+	return GetOwnerRole() == ROLE_Authority || bInventoryFullySynced;
 }
 
 bool UGCActorInventoryComponent::CraftItem(FGameplayTag itemTag)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_CraftItem);
+	CSV_SCOPED_TIMING_STAT(GCInventory, CraftItem);
+
 	const auto ownerActor = GetOwner();
 
 	if (auto inventorySubsystem = UGCInventoryGISSubsystems::Get(ownerActor))
 	{
-		const auto itemRecipe = inventorySubsystem->GetItemRecipe(itemTag);
+		if (const auto itemRecipe = inventorySubsystem->FindCompiledRecipe(itemTag))
+		{
+			const auto ingredients = inventorySubsystem->GetRecipeIngredients(*itemRecipe);
+
+			if (IsItemCraftable(ingredients))
+			{
+				FGCInventoryDelta craftDelta;
+				AddIngredientsToItems(ingredients, 1, craftDelta.ItemsToRemove);
+				craftDelta.ItemsToAdd.Add(itemTag, itemRecipe->CraftedQuantity);
+
+				if (ApplyInventoryDelta(craftDelta))
+				{
+					NotifyItemCrafted(ownerActor, itemTag, itemRecipe->CraftedQuantity);
+
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+int32 UGCActorInventoryComponent::CraftItemBatch(FGameplayTag itemTag, int32 count /*= 1*/)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_CraftItemBatch);
+	CSV_SCOPED_TIMING_STAT(GCInventory, CraftItemBatch);
+
+	if (count <= 0)
+	{
+		return 0;
+	}
 
-		if (IsItemCraftable(itemRecipe))
+	const auto ownerActor = GetOwner();
+
+	if (auto inventorySubsystem = UGCInventoryGISSubsystems::Get(ownerActor))
+	{
+		if (const auto itemRecipe = inventorySubsystem->FindCompiledRecipe(itemTag))
 		{
-			for (const auto& recipeElement : itemRecipe.RecipeElements)
+			const auto ingredients = inventorySubsystem->GetRecipeIngredients(*itemRecipe);
+			const int32 maxCraftable = ComputeMaxCraftableAmount(ingredients);
+			const int32 numCrafts = FMath::Min(count, maxCraftable);
+
+			if (numCrafts <= 0)
+			{
+				return 0;
+			}
+
+			FGCInventoryDelta craftDelta;
+			AddIngredientsToItems(ingredients, numCrafts, craftDelta.ItemsToRemove);
+
+			// numCrafts * amount can land a rounding error above the held stack it was computed from, which would reject the whole delta
+			for (auto& itemToRemove : craftDelta.ItemsToRemove)
 			{
-				RemoveItemFromInventory(recipeElement.Key, recipeElement.Value);
+				const float heldStack = GetItemStack(itemToRemove.Key);
+
+				if (itemToRemove.Value > heldStack && FMath::IsNearlyEqual(itemToRemove.Value, heldStack, FMath::Max(heldStack, 1.f) * KINDA_SMALL_NUMBER))
+				{
+					itemToRemove.Value = heldStack;
+				}
 			}
 
-			if (AddItemToInventory(itemTag, itemRecipe.CraftedQuantity))
+			const float craftedQuantity = numCrafts * itemRecipe->CraftedQuantity;
+			craftDelta.ItemsToAdd.Add(itemTag, craftedQuantity);
+
+			if (ApplyInventoryDelta(craftDelta))
 			{
-				IGCInventoryInterface::Execute_ItemCrafted(ownerActor, itemTag, itemRecipe.CraftedQuantity);
+				NotifyItemCrafted(ownerActor, itemTag, craftedQuantity);
 
-				return true;
-			}			
+				return numCrafts;
+			}
 		}
 	}
 
-	return false;
+	return 0;
+}
+
+int32 UGCActorInventoryComponent::CraftMaxItemBatch(FGameplayTag itemTag)
+{
+	return CraftItemBatch(itemTag, MAX_int32);
 }
 
-bool UGCActorInventoryComponent::ConsumeItemRecipe(const FGameplayTag& itemTag)
+bool UGCActorInventoryComponent::ConsumeItemRecipe(const FGameplayTag& itemTag, TMap<FGameplayTag, float>* outConsumedItems /*= nullptr*/)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_ConsumeItemRecipe);
+	CSV_SCOPED_TIMING_STAT(GCInventory, ConsumeItemRecipe);
+
 	const auto ownerActor = GetOwner();
 
 	if (auto inventorySubsystem = UGCInventoryGISSubsystems::Get(ownerActor))
 	{
-		const auto itemRecipe = inventorySubsystem->GetItemRecipe(itemTag);
+		const auto itemRecipe = inventorySubsystem->FindCompiledRecipe(itemTag);
 
-		if (!IsItemCraftable(itemRecipe))
+		if (!itemRecipe)
 		{
 			return false;
 		}
 
-		for (const auto& recipeElement : itemRecipe.RecipeElements)
+		const auto ingredients = inventorySubsystem->GetRecipeIngredients(*itemRecipe);
+
+		if (!IsItemCraftable(ingredients))
 		{
-			RemoveItemFromInventory(recipeElement.Key, recipeElement.Value);
+			return false;
 		}
 
-		IGCInventoryInterface::Execute_ItemRecipeConsumed(ownerActor, itemTag);
+		FGCInventoryDelta consumeDelta;
+		AddIngredientsToItems(ingredients, 1, consumeDelta.ItemsToRemove);
+
+		// a recipe made only of ingredients without amount takes nothing
+		if (!consumeDelta.IsEmpty() && !ApplyInventoryDelta(consumeDelta))
+		{
+			return false;
+		}
+
+		if (outConsumedItems)
+		{
+			for (const auto& consumedItem : consumeDelta.ItemsToRemove)
+			{
+				outConsumedItems->FindOrAdd(consumedItem.Key) += consumedItem.Value;
+			}
+		}
+
+		NotifyItemRecipeConsumed(ownerActor, itemTag);
 		
 		return true;
 	}
@@ -232,21 +541,50 @@ bool UGCActorInventoryComponent::ConsumeItemRecipe(const FGameplayTag& itemTag)
 
 bool UGCActorInventoryComponent::CanItemBeCrafted(FGameplayTag itemTag) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_CanItemBeCrafted);
+	CSV_SCOPED_TIMING_STAT(GCInventory, CanItemBeCrafted);
+
 	const auto ownerActor = GetOwner();
 
-	if (auto inventorySubsystem = UGCInventoryGISSubsystems::Get(ownerActor))
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(ownerActor))
 	{
-		const auto itemRecipe = inventorySubsystem->GetItemRecipe(itemTag);
+		// recipes compiled after the amounts were tracked (on demand categories) fall back to checking the ingredients
+		if (AreCraftableRecipesTracked(inventorySubsystem->GetCompiledRecipes()))
+		{
+			const int32 recipeIndex = inventorySubsystem->GetCompiledRecipes().FindRecipeIndex(itemTag);
+			return recipeIndex != INDEX_NONE && CraftableRecipes[recipeIndex];
+		}
 
-		return IsItemCraftable(itemRecipe);
+		if (const auto itemRecipe = inventorySubsystem->FindCompiledRecipe(itemTag))
+		{
+			return IsItemCraftable(inventorySubsystem->GetRecipeIngredients(*itemRecipe));
+		}
 	}
 
 	return false;
 }
 
-void UGCActorInventoryComponent::BindEventToItemUpdated(const FGameplayTag itemTag, const UObject* delegateOwner, const FDynamicOnStackItemReplicated& eventDelegate)
+FGCItemUpdatedEventHandle UGCActorInventoryComponent::BindEventToItemUpdated(const FGameplayTag itemTag, const UObject* delegateOwner, const FDynamicOnStackItemReplicated& eventDelegate)
+{
+	FGCItemUpdatedEventHandle eventHandle;
+	eventHandle.ItemTag = itemTag;
+	eventHandle.Handle = HeldItemTags.BindDelegateToStackReplicated(itemTag, eventDelegate, delegateOwner);
+
+	return eventHandle;
+}
+
+void UGCActorInventoryComponent::UnbindEventFromItemUpdated(const FGameplayTag itemTag, const UObject* delegateOwner)
+{
+	HeldItemTags.UnsubscribeFromTag(itemTag, delegateOwner);
+}
+
+void UGCActorInventoryComponent::UnbindItemUpdatedEvent(FGCItemUpdatedEventHandle& eventHandle)
 {
-	HeldItemTags.BindDelegateToStackReplicated(itemTag, eventDelegate, delegateOwner);
+	if (eventHandle.IsValid())
+	{
+		HeldItemTags.UnsubscribeFromTag(eventHandle.ItemTag, eventHandle.Handle);
+		eventHandle.Handle.Reset();
+	}
 }
 
 void UGCActorInventoryComponent::BindEventToItemTagStackUpdated(FOnTagStackUpdatedDynamicDelegate eventDelegate)
@@ -277,44 +615,674 @@ bool UGCActorInventoryComponent::IsItemCraftable(const FItemRecipeElements& reci
 	return bHasMaterials;
 }
 
-int32 UGCActorInventoryComponent::FindMaxCraftableAmount(const FGameplayTag& itemTag) const
+bool UGCActorInventoryComponent::IsItemCraftable(TConstArrayView<FGCRecipeIngredient> ingredients) const
 {
-	const auto ownerActor = GetOwner();
-
-	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(ownerActor))
+	if (ingredients.Num() == 0)
 	{
-		const auto itemRecipe = inventorySubsystem->GetItemRecipe(itemTag);
+		return false;
+	}
 
-		if (!IsItemCraftable(itemRecipe))
+	for (const auto& ingredient : ingredients)
+	{
+		if (GetIngredientStack(ingredient) < ingredient.Amount)
 		{
-			return 0;
+			return false;
 		}
+	}
+
+	return true;
+}
 
-		TArray<int32> maxNumPerIngredient;
-		maxNumPerIngredient.Reserve(itemRecipe.RecipeElements.Num());
+void UGCActorInventoryComponent::AddIngredientsToItems(TConstArrayView<FGCRecipeIngredient> ingredients, int32 numCrafts, TMap<FGameplayTag, float>& outItems)
+{
+	outItems.Reserve(outItems.Num() + ingredients.Num());
 
-		// find max per ingredient
-		for (const auto& element : itemRecipe.RecipeElements)
+	for (const auto& ingredient : ingredients)
+	{
+		// ingredients without amount take nothing, and IsInventoryDeltaValid rejects removing nothing
+		if (ingredient.Amount > 0.f)
 		{
-			const auto& ingredientItemTag = element.Key;
-			const float& ingredientAmount = element.Value;
+			outItems.FindOrAdd(ingredient.ItemTag) += numCrafts * ingredient.Amount;
+		}
+	}
+}
 
-			const float currentAmountInInventory = GetItemStack(ingredientItemTag);
+int32 UGCActorInventoryComponent::ComputeMaxCraftableAmount(TConstArrayView<FGCRecipeIngredient> ingredients) const
+{
+	if (ingredients.Num() == 0)
+	{
+		return 0;
+	}
 
-			const float maxNum = currentAmountInInventory / ingredientAmount;
+	// the ingredient we have the least of limits how many items we can craft
+	int32 maxCraftable = MAX_int32;
 
-			maxNumPerIngredient.Add(static_cast<int32>(maxNum));
+	for (const auto& ingredient : ingredients)
+	{
+		if (ingredient.Amount <= 0.f)
+		{
+			continue;
 		}
 
-		// the minimum amount of the ingredients is the maximum that we can craft for that 
-		maxNumPerIngredient.Sort(
-			[](const int32 a, const int32 b) 
+		const int32 maxPerIngredient = static_cast<int32>(GetIngredientStack(ingredient) / ingredient.Amount);
+
+		if (maxPerIngredient < maxCraftable)
+		{
+			maxCraftable = maxPerIngredient;
+
+			if (maxCraftable <= 0)
 			{
-				return a < b;
-			});
+				return 0;
+			}
+		}
+	}
+
+	return maxCraftable != MAX_int32 ? maxCraftable : 0;
+}
 
-		return !maxNumPerIngredient.IsEmpty() ? maxNumPerIngredient[0] : 0;
+float UGCActorInventoryComponent::GetIngredientStack(const FGCRecipeIngredient& ingredient) const
+{
+	if (HeldItemTags.IsDenseStorageEnabled() && ingredient.ItemId != INDEX_NONE)
+	{
+		return HeldItemTags.GetStackCountById(ingredient.ItemId);
 	}
 
-	return 0;
+	return HeldItemTags.GetStackCount(ingredient.ItemTag);
+}
+
+void UGCActorInventoryComponent::EnableDenseItemStorage()
+{
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(this))
+	{
+		HeldItemTags.EnableDenseStorage(&inventorySubsystem->GetItemIdRegistry());
+
+		// held items may only get their id later, mirroring the stacks again picks them up
+		inventorySubsystem->OnItemIdsAdded.AddUObject(this, &ThisClass::HandleItemIdsAdded);
+	}
+}
+
+void UGCActorInventoryComponent::HandleItemIdsAdded()
+{
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(this))
+	{
+		HeldItemTags.EnableDenseStorage(&inventorySubsystem->GetItemIdRegistry());
+	}
+}
+
+void UGCActorInventoryComponent::EnableCraftableRecipesTracking()
+{
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(this))
+	{
+		bCraftableRecipesTracked = true;
+
+		// recipe indices change when the recipes are compiled again
+		inventorySubsystem->OnCompiledRecipesChanged.AddUObject(this, &ThisClass::RefreshAllCraftableRecipes);
+
+		// local changes, the replicated ones are handled with the rest of the replicated changes
+		HeldItemTags.OnTagStackChanged.RemoveAll(this);
+		HeldItemTags.OnTagStackChanged.AddUObject(this, &ThisClass::RefreshCraftableRecipesUsing);
+
+		RefreshAllCraftableRecipes();
+	}
+}
+
+void UGCActorInventoryComponent::RefreshAllCraftableRecipes()
+{
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(this))
+	{
+		const auto& compiledRecipes = inventorySubsystem->GetCompiledRecipes();
+		const int32 numRecipes = compiledRecipes.GetRecipes().Num();
+
+		MaxCraftableAmounts.SetNumUninitialized(numRecipes);
+		CraftableRecipes.Init(false, numRecipes);
+
+		for (int32 recipeIndex = 0; recipeIndex < numRecipes; ++recipeIndex)
+		{
+			RefreshCraftableRecipe(compiledRecipes, recipeIndex);
+		}
+	}
+}
+
+void UGCActorInventoryComponent::RefreshCraftableRecipesUsing(const FGameplayTag& itemTag)
+{
+	if (!itemTag.IsValid())
+	{
+		RefreshAllCraftableRecipes();
+		return;
+	}
+
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(this))
+	{
+		const auto& compiledRecipes = inventorySubsystem->GetCompiledRecipes();
+
+		if (!AreCraftableRecipesTracked(compiledRecipes))
+		{
+			RefreshAllCraftableRecipes();
+			return;
+		}
+
+		for (const int32 recipeIndex : compiledRecipes.GetRecipesUsingIngredient(itemTag))
+		{
+			RefreshCraftableRecipe(compiledRecipes, recipeIndex);
+		}
+	}
+}
+
+void UGCActorInventoryComponent::RefreshCraftableRecipe(const FGCCompiledRecipeTable& compiledRecipes, int32 recipeIndex)
+{
+	const auto ingredients = compiledRecipes.GetIngredients(compiledRecipes.GetRecipes()[recipeIndex]);
+	const int32 maxCraftable = ComputeMaxCraftableAmount(ingredients);
+
+	MaxCraftableAmounts[recipeIndex] = maxCraftable;
+	// ingredients with no amount are not counted by the max craftable amount, IsItemCraftable stays the reference
+	CraftableRecipes[recipeIndex] = maxCraftable > 0 || IsItemCraftable(ingredients);
+}
+
+void UGCActorInventoryComponent::HandleHeldItemStackDirty(const FGameplayTag& itemTag)
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, HeldItemTags, this);
+
+	UpdateNumHeldItemStacks();
+
+	if (ReplicationMode != EGCInventoryReplicationMode::OwnerWithPublicSubset)
+	{
+		return;
+	}
+
+	if (itemTag.IsValid())
+	{
+		if (IsPublicItem(itemTag))
+		{
+			SyncPublicItemStack(itemTag);
+		}
+		return;
+	}
+
+	// every stack changed, the public items are copied again
+	PublicHeldItemTags.ClearStack();
+
+	for (const auto& itemStack : HeldItemTags.GetGameplayTagStackList())
+	{
+		if (IsPublicItem(itemStack.GetGameplayTag()))
+		{
+			PublicHeldItemTags.AddStack(itemStack.GetGameplayTag(), itemStack.GetStackCount());
+		}
+	}
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, PublicHeldItemTags, this);
+}
+
+bool UGCActorInventoryComponent::IsPublicItem(const FGameplayTag& itemTag) const
+{
+	return itemTag.MatchesAny(PublicItemTags);
+}
+
+void UGCActorInventoryComponent::SyncPublicItemStack(const FGameplayTag& itemTag)
+{
+	const float heldStack = HeldItemTags.GetStackCount(itemTag);
+	const float publicStack = PublicHeldItemTags.GetStackCount(itemTag);
+
+	if (heldStack > publicStack)
+	{
+		PublicHeldItemTags.AddStack(itemTag, heldStack - publicStack);
+	}
+	else if (heldStack < publicStack)
+	{
+		PublicHeldItemTags.RemoveStack(itemTag, publicStack - heldStack);
+	}
+	else
+	{
+		return;
+	}
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, PublicHeldItemTags, this);
+}
+
+void UGCActorInventoryComponent::UpdateNumHeldItemStacks()
+{
+	const int32 numStacks = HeldItemTags.GetGameplayTagStackList().Num();
+
+	if (NumHeldItemStacks != numStacks)
+	{
+		NumHeldItemStacks = numStacks;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, NumHeldItemStacks, this);
+	}
+}
+
+void UGCActorInventoryComponent::OnRep_NumHeldItemStacks()
+{
+	CheckInventoryFullySynced();
+}
+
+void UGCActorInventoryComponent::MarkCraftingJobsDirty()
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, CraftingJobs, this);
+
+	OnCraftingJobsChanged.Broadcast(GetOwner());
+}
+
+void UGCActorInventoryComponent::OnRep_CraftingJobs()
+{
+	OnCraftingJobsChanged.Broadcast(GetOwner());
+}
+
+void UGCActorInventoryComponent::CheckInventoryFullySynced()
+{
+	if (bInventoryFullySynced || NumHeldItemStacks == INDEX_NONE || GetOwnerRole() == ROLE_Authority)
+	{
+		return;
+	}
+
+	if (HeldItemTags.GetGameplayTagStackList().Num() >= NumHeldItemStacks)
+	{
+		bInventoryFullySynced = true;
+
+		OnInventoryFullySynced.Broadcast(GetOwner());
+	}
+}
+
+void UGCActorInventoryComponent::HandleHeldItemsReplicatedReceive()
+{
+	if (bDeferReplicatedChangesToEndOfFrame && HeldItemTags.HasPendingReplicatedChanges() && !EndOfFrameFlushHandle.IsValid())
+	{
+		EndOfFrameFlushHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &ThisClass::FlushHeldItemsReplicatedChanges);
+	}
+
+	CheckInventoryFullySynced();
+}
+
+void UGCActorInventoryComponent::HandleHeldItemsReplicated(TConstArrayView<FGCTagStackChange> changes)
+{
+	if (bCraftableRecipesTracked)
+	{
+		for (const auto& change : changes)
+		{
+			RefreshCraftableRecipesUsing(change.Tag);
+		}
+	}
+
+	if (OnHeldItemsReplicated.IsBound())
+	{
+		OnHeldItemsReplicated.Broadcast(TArray<FGCTagStackChange>(changes.GetData(), changes.Num()), GetOwner());
+	}
+}
+
+void UGCActorInventoryComponent::FlushHeldItemsReplicatedChanges()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndOfFrameFlushHandle);
+	EndOfFrameFlushHandle.Reset();
+
+	HeldItemTags.FlushReplicatedChanges();
+}
+
+bool UGCActorInventoryComponent::IsInventoryDeltaValid(const FGCInventoryDelta& delta) const
+{
+	if (delta.IsEmpty())
+	{
+		return false;
+	}
+
+	for (const auto& removedItem : delta.ItemsToRemove)
+	{
+		if (!removedItem.Key.IsValid() || removedItem.Value <= 0.f || !ContainsItemInInventory(removedItem.Key, removedItem.Value))
+		{
+			UE_LOG(LogGCActorInventoryComponent, Verbose, TEXT("[%s] Cannot remove %f of %s from the inventory"), ANSI_TO_TCHAR(__FUNCTION__), removedItem.Value, *removedItem.Key.ToString());
+			return false;
+		}
+	}
+
+	for (const auto& addedItem : delta.ItemsToAdd)
+	{
+		if (!addedItem.Key.IsValid() || addedItem.Value <= 0.f)
+		{
+			UE_LOG(LogGCActorInventoryComponent, Verbose, TEXT("[%s] Cannot add %f of %s to the inventory"), ANSI_TO_TCHAR(__FUNCTION__), addedItem.Value, *addedItem.Key.ToString());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool UGCActorInventoryComponent::CanApplyInventoryDelta(const FGCInventoryDelta& delta)
+{
+	return GetInventoryInterfaceOwner() && IsInventoryDeltaValid(delta);
+}
+
+int32 UGCActorInventoryComponent::FindMaxCraftableAmount(const FGameplayTag& itemTag) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_FindMaxCraftableAmount);
+	CSV_SCOPED_TIMING_STAT(GCInventory, FindMaxCraftableAmount);
+
+	const auto ownerActor = GetOwner();
+
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(ownerActor))
+	{
+		if (AreCraftableRecipesTracked(inventorySubsystem->GetCompiledRecipes()))
+		{
+			const int32 recipeIndex = inventorySubsystem->GetCompiledRecipes().FindRecipeIndex(itemTag);
+			return recipeIndex != INDEX_NONE ? MaxCraftableAmounts[recipeIndex] : 0;
+		}
+
+		if (const auto itemRecipe = inventorySubsystem->FindCompiledRecipe(itemTag))
+		{
+			return ComputeMaxCraftableAmount(inventorySubsystem->GetRecipeIngredients(*itemRecipe));
+		}
+	}
+
+	return 0;
+}
+
+int32 UGCActorInventoryComponent::QueueItemCraft(FGameplayTag itemTag)
+{
+	if (const auto craftingScheduler = UGCCraftingSchedulerSubsystem::Get(this))
+	{
+		return craftingScheduler->QueueCraft(this, itemTag);
+	}
+
+	return INDEX_NONE;
+}
+
+bool UGCActorInventoryComponent::CancelItemCraft(int32 jobId)
+{
+	if (const auto craftingScheduler = UGCCraftingSchedulerSubsystem::Get(this))
+	{
+		return craftingScheduler->CancelCraft(this, jobId);
+	}
+
+	return false;
+}
+
+float UGCActorInventoryComponent::GetCraftingJobProgress(int32 jobId) const
+{
+	const auto craftingJob = CraftingJobs.FindByPredicate([jobId](const FGCCraftingJob& job)
+		{
+			return job.JobId == jobId;
+		});
+
+	if (!craftingJob || !craftingJob->IsStarted())
+	{
+		return 0.f;
+	}
+
+	if (craftingJob->Duration <= 0.f)
+	{
+		return 1.f;
+	}
+
+	// the start time is a server time, clients compare it against their estimate of the server time
+	const auto world = GetWorld();
+	const auto gameState = world->GetGameState();
+	const double currentTime = gameState ? gameState->GetServerWorldTimeSeconds() : world->GetTimeSeconds();
+
+	return FMath::Clamp(static_cast<float>((currentTime - craftingJob->StartTime) / craftingJob->Duration), 0.f, 1.f);
+}
+
+int32 UGCActorInventoryComponent::CraftItemFromSources(FGameplayTag itemTag, const TArray<UGCActorInventoryComponent*>& otherSources, int32 count /*= 1*/)
+{
+	FGCCraftingContext craftingContext;
+	craftingContext.AddSource(this);
+
+	for (const auto source : otherSources)
+	{
+		craftingContext.AddSource(source);
+	}
+
+	return craftingContext.CraftItem(itemTag, count);
+}
+
+int32 UGCActorInventoryComponent::CraftMaxItemFromSources(FGameplayTag itemTag, const TArray<UGCActorInventoryComponent*>& otherSources)
+{
+	return CraftItemFromSources(itemTag, otherSources, MAX_int32);
+}
+
+int32 UGCActorInventoryComponent::FindMaxCraftableAmountFromSources(FGameplayTag itemTag, const TArray<UGCActorInventoryComponent*>& otherSources) const
+{
+	FGCCraftingContext craftingContext;
+	craftingContext.AddReadOnlySource(this);
+
+	for (const auto source : otherSources)
+	{
+		craftingContext.AddReadOnlySource(source);
+	}
+
+	return craftingContext.FindMaxCraftableAmount(itemTag);
+}
+
+bool UGCActorInventoryComponent::PlanItemCraft(FGameplayTag itemTag, int32 numCrafts, FGCCraftingPlan& outPlan) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_PlanItemCraft);
+	CSV_SCOPED_TIMING_STAT(GCInventory, PlanItemCraft);
+
+	outPlan = FGCCraftingPlan();
+
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(GetOwner()))
+	{
+		const auto& compiledRecipes = inventorySubsystem->GetCompiledRecipes();
+		const int32 recipeIndex = compiledRecipes.FindRecipeIndex(itemTag);
+
+		if (recipeIndex != INDEX_NONE)
+		{
+			return inventorySubsystem->GetRecipeGraph().BuildCraftingPlan(compiledRecipes, recipeIndex, numCrafts, [this](const FGameplayTag& heldItemTag)
+				{
+					return HeldItemTags.GetStackCount(heldItemTag);
+				}, outPlan);
+		}
+	}
+
+	return false;
+}
+
+bool UGCActorInventoryComponent::CraftItemWithIntermediates(FGameplayTag itemTag, int32 numCrafts /*= 1*/)
+{
+	FGCCraftingPlan craftingPlan;
+
+	if (!PlanItemCraft(itemTag, numCrafts, craftingPlan) || !ApplyInventoryDelta(craftingPlan.Delta))
+	{
+		return false;
+	}
+
+	// the plan carries the crafted amounts, the recipes may have been compiled again by the listeners of the delta
+	if (const auto ownerActor = GetInventoryInterfaceOwner())
+	{
+		for (const auto& step : craftingPlan.Steps)
+		{
+			NotifyItemCrafted(ownerActor, step.ItemTag, step.CraftedAmount);
+		}
+	}
+
+	return true;
+}
+
+TArray<FGameplayTag> UGCActorInventoryComponent::GetCraftableItems() const
+{
+	TArray<FGameplayTag> craftableItems;
+
+	if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(GetOwner()))
+	{
+		const auto recipes = inventorySubsystem->GetCompiledRecipes().GetRecipes();
+
+		if (AreCraftableRecipesTracked(inventorySubsystem->GetCompiledRecipes()))
+		{
+			for (TConstSetBitIterator<> craftableIt(CraftableRecipes); craftableIt; ++craftableIt)
+			{
+				craftableItems.Add(recipes[craftableIt.GetIndex()].ItemTag);
+			}
+		}
+		else
+		{
+			for (const auto& recipe : recipes)
+			{
+				if (IsItemCraftable(inventorySubsystem->GetRecipeIngredients(recipe)))
+				{
+					craftableItems.Add(recipe.ItemTag);
+				}
+			}
+		}
+	}
+
+	return craftableItems;
+}
+
+void UGCActorInventoryComponent::BroadcastItemEvent(EGCInventoryItemEventType eventType, const FGameplayTag& itemTag, float itemStack)
+{
+	if (bDeferItemEvents)
+	{
+		if (const auto eventSubsystem = UGCInventoryEventSubsystem::Get(this))
+		{
+			eventSubsystem->QueueItemEvent(this, eventType, itemTag, itemStack);
+			return;
+		}
+	}
+
+	DispatchItemEvent(eventType, itemTag, itemStack);
+}
+
+void UGCActorInventoryComponent::DispatchItemEvent(EGCInventoryItemEventType eventType, const FGameplayTag& itemTag, float itemStack)
+{
+	const auto ownerActor = GetOwner();
+
+	switch (eventType)
+	{
+	case EGCInventoryItemEventType::Granted:
+		OnItemGranted.Broadcast(itemTag, itemStack, ownerActor);
+		break;
+	case EGCInventoryItemEventType::Used:
+		OnItemUsed.Broadcast(itemTag, itemStack, ownerActor);
+		break;
+	case EGCInventoryItemEventType::Removed:
+		OnItemRemoved.Broadcast(itemTag, itemStack, ownerActor);
+		break;
+	}
+}
+
+void UGCActorInventoryComponent::CacheInventoryInterface()
+{
+	using namespace GCActorInventoryComponent;
+
+	const auto ownerActor = GetOwner();
+
+	InventoryInterfaceOwner = ownerActor;
+	NativeInventoryInterface = Cast<IGCInventoryInterface>(ownerActor);
+	bOwnerImplementsInventoryInterface = ownerActor && ownerActor->GetClass()->ImplementsInterface(UGCInventoryInterface::StaticClass());
+	NativeInventoryEvents = 0;
+
+	if (NativeInventoryInterface)
+	{
+		const auto ownerClass = ownerActor->GetClass();
+
+		const TPair<FName, uint8> inventoryEvents[] =
+		{
+			{ GET_FUNCTION_NAME_CHECKED(IGCInventoryInterface, ItemGranted), ItemGrantedEvent },
+			{ GET_FUNCTION_NAME_CHECKED(IGCInventoryInterface, ItemUsed), ItemUsedEvent },
+			{ GET_FUNCTION_NAME_CHECKED(IGCInventoryInterface, ItemRemoved), ItemRemovedEvent },
+			{ GET_FUNCTION_NAME_CHECKED(IGCInventoryInterface, ItemDropped), ItemDroppedEvent },
+			{ GET_FUNCTION_NAME_CHECKED(IGCInventoryInterface, AllItemsDropped), AllItemsDroppedEvent },
+			{ GET_FUNCTION_NAME_CHECKED(IGCInventoryInterface, ItemCrafted), ItemCraftedEvent },
+			{ GET_FUNCTION_NAME_CHECKED(IGCInventoryInterface, ItemRecipeConsumed), ItemRecipeConsumedEvent },
+		};
+
+		for (const auto& inventoryEvent : inventoryEvents)
+		{
+			if (IsEventNative(ownerClass, inventoryEvent.Key))
+			{
+				NativeInventoryEvents |= inventoryEvent.Value;
+			}
+		}
+	}
+}
+
+AActor* UGCActorInventoryComponent::GetInventoryInterfaceOwner()
+{
+	const auto ownerActor = GetOwner();
+
+	if (ownerActor != InventoryInterfaceOwner)
+	{
+		CacheInventoryInterface();
+	}
+
+	return bOwnerImplementsInventoryInterface ? ownerActor : nullptr;
+}
+
+void UGCActorInventoryComponent::NotifyItemGranted(AActor* ownerActor, const FGameplayTag& itemTag, float itemStack)
+{
+	if (IsNativeInventoryEvent(GCActorInventoryComponent::ItemGrantedEvent))
+	{
+		NativeInventoryInterface->ItemGranted_Implementation(itemTag, itemStack);
+	}
+	else
+	{
+		IGCInventoryInterface::Execute_ItemGranted(ownerActor, itemTag, itemStack);
+	}
+}
+
+void UGCActorInventoryComponent::NotifyItemUsed(AActor* ownerActor, const FGameplayTag& itemTag, float itemStack)
+{
+	if (IsNativeInventoryEvent(GCActorInventoryComponent::ItemUsedEvent))
+	{
+		NativeInventoryInterface->ItemUsed_Implementation(itemTag, itemStack);
+	}
+	else
+	{
+		IGCInventoryInterface::Execute_ItemUsed(ownerActor, itemTag, itemStack);
+	}
+}
+
+void UGCActorInventoryComponent::NotifyItemRemoved(AActor* ownerActor, const FGameplayTag& itemTag, float itemStack)
+{
+	if (IsNativeInventoryEvent(GCActorInventoryComponent::ItemRemovedEvent))
+	{
+		NativeInventoryInterface->ItemRemoved_Implementation(itemTag, itemStack);
+	}
+	else
+	{
+		IGCInventoryInterface::Execute_ItemRemoved(ownerActor, itemTag, itemStack);
+	}
+}
+
+void UGCActorInventoryComponent::NotifyItemDropped(AActor* ownerActor, const FGameplayTag& itemTag, float itemStack)
+{
+	if (IsNativeInventoryEvent(GCActorInventoryComponent::ItemDroppedEvent))
+	{
+		NativeInventoryInterface->ItemDropped_Implementation(itemTag, itemStack);
+	}
+	else
+	{
+		IGCInventoryInterface::Execute_ItemDropped(ownerActor, itemTag, itemStack);
+	}
+}
+
+void UGCActorInventoryComponent::NotifyAllItemsDropped(AActor* ownerActor)
+{
+	if (IsNativeInventoryEvent(GCActorInventoryComponent::AllItemsDroppedEvent))
+	{
+		NativeInventoryInterface->AllItemsDropped_Implementation();
+	}
+	else
+	{
+		IGCInventoryInterface::Execute_AllItemsDropped(ownerActor);
+	}
+}
+
+void UGCActorInventoryComponent::NotifyItemCrafted(AActor* ownerActor, const FGameplayTag& itemTag, float amount)
+{
+	if (IsNativeInventoryEvent(GCActorInventoryComponent::ItemCraftedEvent))
+	{
+		NativeInventoryInterface->ItemCrafted_Implementation(itemTag, amount);
+	}
+	else
+	{
+		IGCInventoryInterface::Execute_ItemCrafted(ownerActor, itemTag, amount);
+	}
+}
+
+void UGCActorInventoryComponent::NotifyItemRecipeConsumed(AActor* ownerActor, const FGameplayTag& itemTag)
+{
+	if (IsNativeInventoryEvent(GCActorInventoryComponent::ItemRecipeConsumedEvent))
+	{
+		NativeInventoryInterface->ItemRecipeConsumed_Implementation(itemTag);
+	}
+	else
+	{
+		IGCInventoryInterface::Execute_ItemRecipeConsumed(ownerActor, itemTag);
+	}
 }
@@ -7,12 +7,18 @@
 
 #include "GCActorInventoryComponent.generated.h"
 
+class IGCInventoryInterface;
+
 DECLARE_LOG_CATEGORY_EXTERN(LogGCActorInventoryComponent, Log, All);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnItemGranted, FGameplayTag, itemName, float, itemStack, AActor*, ownerReference);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnItemUsed, FGameplayTag, itemName, float, itemStack, AActor*, ownerReference);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnItemRemoved, FGameplayTag, itemName, float, itemStack, AActor*, ownerReference);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnDropAllItemsFromInventoryDelegate);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnInventoryDeltaApplied, const FGCInventoryDelta&, delta, AActor*, ownerReference);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventoryFullySynced, AActor*, ownerReference);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHeldItemsReplicated, const TArray<FGCTagStackChange>&, changes, AActor*, ownerReference);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCraftingJobsChanged, AActor*, ownerReference);
 
 /**
  *  Inventory component used to manage the inventory of players during the game.
@@ -24,15 +30,23 @@ class GCINVENTORYSYSTEM_API UGCActorInventoryComponent : public UActorComponent
 {
 	GENERATED_BODY()
 
+	friend class UGCInventoryEventSubsystem;
+	friend class FGCCraftingContext;
+	friend class UGCCraftingSchedulerSubsystem;
+
 public:
 
 	UGCActorInventoryComponent(const FObjectInitializer& ObjectInitializer);
 
 	// Begin UActorComponent Interface
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	// End UActorComponent Interface
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 
 	// Function called to add an item to the inventory with a specific stack
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
@@ -58,6 +72,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
 	void RemoveAllItemsFromInventory();
 
+	// Applies all the additions and removals of the delta, or none of them if any removal cannot be fulfilled.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
+	bool ApplyInventoryDelta(const FGCInventoryDelta& delta);
+
 	// Fast function to remove all elements in the inventory and empty it in a fast way.
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
 	void ClearInventory();
@@ -74,20 +92,52 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
 	float GetItemStack(FGameplayTag itemTag) const;
 
-	// Returns the current stack of the input item from the inventory. 0 if the player doesn't have the item.
+	// Returns every held item with its stack. The map is cached and only rebuilt after the inventory changed.
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
-	TMap<FGameplayTag, float> GetAllItemsOnInventory() const;
+	const TMap<FGameplayTag, float>& GetAllItemsOnInventory() const;
 
+	// Returns the sum of the stacks of every held item, kept up to date by the inventory changes
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
 	float GetTotalAmountItems() const;
 
+	// Returns a number that changes every time the held items change, to know when data built from them is out of date
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
+	int32 GetInventoryVersion() const;
+
+	// Returns the held item changes made after the inventory version, or every held item when they are no longer all journaled (see HeldItemsJournalCapacity)
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
+	void GetInventoryChangesSince(int32 sinceVersion, FGCTagStackDiff& outDiff) const;
+
+	// Non-owning view over the held items that does not allocate, only valid until the inventory changes
+	TConstArrayView<FGCGameplayTagStack> GetHeldItemsView() const
+	{
+		return HeldItemTags.GetStacksView();
+	}
+
+	// Returns the stack of a public item. Unlike GetItemStack it also works on clients that do not own the inventory when ReplicationMode is OwnerWithPublicSubset.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
+	float GetPublicItemStack(FGameplayTag itemTag) const;
+
+	// Returns true once this client received every held item. Always true on the server.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
+	bool IsInventoryFullySynced() const;
+
 	//~ Crafting related functions
 
 	// Function called to craft the desired item.
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
 	bool CraftItem(FGameplayTag itemTag);
 
-	bool ConsumeItemRecipe(const FGameplayTag& itemTag);
+	// Crafts the item up to count times with a single inventory delta, fewer if the ingredients run out. Returns how many times it was crafted.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	int32 CraftItemBatch(FGameplayTag itemTag, int32 count = 1);
+
+	// Crafts the item as many times as the held ingredients allow with a single inventory delta. Returns how many times it was crafted.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	int32 CraftMaxItemBatch(FGameplayTag itemTag);
+
+	// Takes the ingredients of one craft of the item without crafting it. The removed items are added to outConsumedItems if given.
+	bool ConsumeItemRecipe(const FGameplayTag& itemTag, TMap<FGameplayTag, float>* outConsumedItems = nullptr);
 
 	// Function called to craft the desired item.
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
@@ -96,8 +146,59 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
 	int32 FindMaxCraftableAmount(const FGameplayTag& itemTag) const;
 
+	// Takes the ingredients of the recipe right away and grants the item once the crafting time of the recipe elapsed.
+	// Jobs are crafted one after the other. Returns the id of the job, or INDEX_NONE if it could not be queued.
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "InventoryComponent|Crafting")
+	int32 QueueItemCraft(FGameplayTag itemTag);
+
+	// Removes the crafting job and gives its ingredients back
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "InventoryComponent|Crafting")
+	bool CancelItemCraft(int32 jobId);
+
+	// Queued crafting jobs, the first one is being crafted
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	const TArray<FGCCraftingJob>& GetCraftingJobs() const { return CraftingJobs; }
+
+	// Returns the progress of the crafting job between 0 and 1, 0 while it waits for the jobs before it
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	float GetCraftingJobProgress(int32 jobId) const;
+
+	// Crafts the item with the ingredients of this inventory first and then of the other sources in order, see FGCCraftingContext.
+	// The crafted items are added to this inventory. Returns how many times the item was crafted, up to count and none if count <= 0 like CraftItemBatch.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	int32 CraftItemFromSources(FGameplayTag itemTag, const TArray<UGCActorInventoryComponent*>& otherSources, int32 count = 1);
+
+	// Crafts the item as many times as the ingredients of this inventory and the other sources allow, see CraftItemFromSources
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	int32 CraftMaxItemFromSources(FGameplayTag itemTag, const TArray<UGCActorInventoryComponent*>& otherSources);
+
+	// Returns how many times the item can be crafted with the ingredients of this inventory and the other sources together
+	UFUNCTION(BlueprintPure, Category = "InventoryComponent|Crafting")
+	int32 FindMaxCraftableAmountFromSources(FGameplayTag itemTag, const TArray<UGCActorInventoryComponent*>& otherSources) const;
+
+	// Plans how to craft the item numCrafts times, crafting first the intermediate ingredients that are missing. Returns true if the plan can be executed.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	bool PlanItemCraft(FGameplayTag itemTag, int32 numCrafts, FGCCraftingPlan& outPlan) const;
+
+	// Crafts the item numCrafts times along with the intermediate ingredients that are missing, all of it as a single inventory delta
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	bool CraftItemWithIntermediates(FGameplayTag itemTag, int32 numCrafts = 1);
+
+	// Returns every item the inventory holds the ingredients for. A plain read when bTrackCraftableRecipes is enabled.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent|Crafting")
+	TArray<FGameplayTag> GetCraftableItems() const;
+
+	// Calls the event every time the stack of the item changes, for as long as the owner is alive. Returns the handle to unbind that event alone.
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
+	FGCItemUpdatedEventHandle BindEventToItemUpdated(const FGameplayTag itemTag, const UObject* delegateOwner, const FDynamicOnStackItemReplicated& eventDelegate);
+
+	// Removes every event the owner bound to the item with BindEventToItemUpdated
+	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
+	void UnbindEventFromItemUpdated(const FGameplayTag itemTag, const UObject* delegateOwner);
+
+	// Removes the event bound with BindEventToItemUpdated that returned the handle, and invalidates the handle
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
-	void BindEventToItemUpdated(const FGameplayTag itemTag, const UObject* delegateOwner, const FDynamicOnStackItemReplicated& eventDelegate);
+	void UnbindItemUpdatedEvent(UPARAM(ref) FGCItemUpdatedEventHandle& eventHandle);
 
 	UFUNCTION(BlueprintCallable, Category = "InventoryComponent")
 	void BindEventToItemTagStackUpdated(const FOnTagStackUpdatedDynamicDelegate eventDelegate);
@@ -106,6 +207,98 @@ protected:
 
 	bool IsItemCraftable(const FItemRecipeElements& recipe) const;
 
+	bool IsItemCraftable(TConstArrayView<FGCRecipeIngredient> ingredients) const;
+
+	// Adds the amounts taken by crafting the ingredients numCrafts times to the items, skipping the ingredients without amount
+	static void AddIngredientsToItems(TConstArrayView<FGCRecipeIngredient> ingredients, int32 numCrafts, TMap<FGameplayTag, float>& outItems);
+
+	// Returns how many times the ingredients can be taken from the inventory, computed in a single pass
+	int32 ComputeMaxCraftableAmount(TConstArrayView<FGCRecipeIngredient> ingredients) const;
+
+	// Returns the held stack of the ingredient, read by item id when dense item storage is enabled
+	float GetIngredientStack(const FGCRecipeIngredient& ingredient) const;
+
+	// Starts mirroring the held items into the dense storage indexed by the item ids of the inventory subsystem
+	void EnableDenseItemStorage();
+
+	void HandleItemIdsAdded();
+
+	// Computes how many times every recipe can be crafted and keeps it up to date from then on
+	void EnableCraftableRecipesTracking();
+
+	void RefreshAllCraftableRecipes();
+
+	// Only re-evaluates the recipes using the item, or every recipe if the tag is invalid
+	void RefreshCraftableRecipesUsing(const FGameplayTag& itemTag);
+
+	void RefreshCraftableRecipe(const FGCCompiledRecipeTable& compiledRecipes, int32 recipeIndex);
+
+	// Returns true if the tracked amounts can be read for the recipes, false while tracking is off or the recipes changed since they were computed
+	bool AreCraftableRecipesTracked(const FGCCompiledRecipeTable& compiledRecipes) const
+	{
+		return bCraftableRecipesTracked && MaxCraftableAmounts.Num() == compiledRecipes.GetRecipes().Num();
+	}
+
+	// Pushes the held items dirty and keeps the public items in sync after a local change
+	void HandleHeldItemStackDirty(const FGameplayTag& itemTag);
+
+	bool IsPublicItem(const FGameplayTag& itemTag) const;
+
+	// Copies the stack of the held item into the public items
+	void SyncPublicItemStack(const FGameplayTag& itemTag);
+
+	// Replicates the number of held stacks, which clients compare against the stacks they received
+	void UpdateNumHeldItemStacks();
+
+	UFUNCTION()
+	void OnRep_NumHeldItemStacks();
+
+	// Replicates the crafting jobs and notifies the listeners on the server
+	void MarkCraftingJobsDirty();
+
+	UFUNCTION()
+	void OnRep_CraftingJobs();
+
+	void CheckInventoryFullySynced();
+
+	void HandleHeldItemsReplicatedReceive();
+
+	void HandleHeldItemsReplicated(TConstArrayView<FGCTagStackChange> changes);
+
+	void FlushHeldItemsReplicatedChanges();
+
+	// Returns true if every element of the delta is well formed and every removal can be fulfilled
+	bool IsInventoryDeltaValid(const FGCInventoryDelta& delta) const;
+
+	// Returns true if ApplyInventoryDelta would apply the delta
+	bool CanApplyInventoryDelta(const FGCInventoryDelta& delta);
+
+	// Broadcasts the item delegate, or queues it in the inventory event subsystem when the item events are deferred
+	void BroadcastItemEvent(EGCInventoryItemEventType eventType, const FGameplayTag& itemTag, float itemStack);
+
+	// Broadcasts a deferred item delegate, called by the inventory event subsystem
+	void DispatchItemEvent(EGCInventoryItemEventType eventType, const FGameplayTag& itemTag, float itemStack);
+
+	// Resolves whether the owner implements the inventory interface and which of its events can skip the blueprint VM
+	void CacheInventoryInterface();
+
+	// Returns the owner if it implements the inventory interface, resolving the binding again if the owner changed
+	AActor* GetInventoryInterfaceOwner();
+
+	bool IsNativeInventoryEvent(uint8 eventFlag) const
+	{
+		return (NativeInventoryEvents & eventFlag) != 0;
+	}
+
+	// Interface events, called on the native implementation directly when the owner class does not override them in blueprint
+	void NotifyItemGranted(AActor* ownerActor, const FGameplayTag& itemTag, float itemStack);
+	void NotifyItemUsed(AActor* ownerActor, const FGameplayTag& itemTag, float itemStack);
+	void NotifyItemRemoved(AActor* ownerActor, const FGameplayTag& itemTag, float itemStack);
+	void NotifyItemDropped(AActor* ownerActor, const FGameplayTag& itemTag, float itemStack);
+	void NotifyAllItemsDropped(AActor* ownerActor);
+	void NotifyItemCrafted(AActor* ownerActor, const FGameplayTag& itemTag, float amount);
+	void NotifyItemRecipeConsumed(AActor* ownerActor, const FGameplayTag& itemTag);
+
 public:
 
 	UPROPERTY(BlueprintAssignable, Category = "Inventory")
@@ -120,12 +313,111 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Inventory")
 	FOnDropAllItemsFromInventoryDelegate OnDropAllItemsFromInventoryDelegate;
 
+	// Broadcasted once per applied delta, after the per item events unless they are deferred
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnInventoryDeltaApplied OnInventoryDeltaApplied;
+
+	// Broadcasted once on the clients that receive the held items, when all of them arrived
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnInventoryFullySynced OnInventoryFullySynced;
+
+	// Broadcasted on clients once per replication update (or once per frame, see bDeferReplicatedChangesToEndOfFrame) with every held item that changed
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnHeldItemsReplicated OnHeldItemsReplicated;
+
+	// Broadcasted when a crafting job is queued, started, completed or cancelled
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnCraftingJobsChanged OnCraftingJobsChanged;
+
 protected:
 
 	// Gameplay tags of the items that the player holds
 	UPROPERTY(Replicated)
 	FGCGameplayTagStackContainer HeldItemTags;
 
+	// Held items matching PublicItemTags, replicated to the connections that do not own the inventory
+	UPROPERTY(Replicated)
+	FGCGameplayTagStackContainer PublicHeldItemTags;
+
+	// Which connections receive the held items. Read when the replicated properties are registered, so it can only be set per class.
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Replication")
+	EGCInventoryReplicationMode ReplicationMode = EGCInventoryReplicationMode::AllConnections;
+
+	// Items (or parents of items) visible to every connection when ReplicationMode is OwnerWithPublicSubset
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Replication", meta = (EditCondition = "ReplicationMode == EGCInventoryReplicationMode::OwnerWithPublicSubset"))
+	FGameplayTagContainer PublicItemTags;
+
+	// Maximum number of held stacks sent per net update to a connection that is missing them (for example when it joins), 0 sends them all at once.
+	// Only used by the legacy replication path.
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Replication", meta = (ClampMin = 0))
+	int32 InitialSyncChunkSize = 0;
+
+	// Items (or parents of items) sent first when the held stacks are sent in chunks, in order. The other items follow.
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Replication", meta = (EditCondition = "InitialSyncChunkSize > 0"))
+	TArray<FGameplayTag> InitialSyncPriorityTags;
+
+	// Number of held stacks on the server, INDEX_NONE until it has been replicated
+	UPROPERTY(ReplicatedUsing = OnRep_NumHeldItemStacks)
+	int32 NumHeldItemStacks = INDEX_NONE;
+
+	bool bInventoryFullySynced = false;
+
+	// Gathers the replicated changes of every update received during a frame and broadcasts them once at the end of the frame
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Replication")
+	bool bDeferReplicatedChangesToEndOfFrame = false;
+
+	FDelegateHandle EndOfFrameFlushHandle;
+
+	// Queues OnItemGranted, OnItemUsed and OnItemRemoved in the inventory event subsystem, which broadcasts them in order within a frame budget.
+	// Keeps bulk changes cheap when the delegates have expensive listeners, but the listeners run in a later frame than the change.
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Events")
+	bool bDeferItemEvents = false;
+
+	// Number of held item changes kept for GetInventoryChangesSince, 0 disables the journal. Callers further behind than that get every held item instead.
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Events", meta = (ClampMin = 0))
+	int32 HeldItemsJournalCapacity = 0;
+
 	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Defaults")
 	TMap<FGameplayTag, float> StartUpItems;
+
+	// Owner the inventory interface binding was resolved for, only compared against GetOwner() and never dereferenced
+	const AActor* InventoryInterfaceOwner = nullptr;
+
+	// Native interface of the owner, nullptr if the owner does not implement it or only implements it in blueprint
+	IGCInventoryInterface* NativeInventoryInterface = nullptr;
+
+	bool bOwnerImplementsInventoryInterface = false;
+
+	// Interface events that the owner class does not override in blueprint
+	uint8 NativeInventoryEvents = 0;
+
+	// Keeps how many times every recipe can be crafted up to date as the held items change, so crafting queries become a lookup.
+	// Costs an int per recipe of the game per inventory, and every held item change re-evaluates the recipes using that item.
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Crafting")
+	bool bTrackCraftableRecipes = false;
+
+	bool bCraftableRecipesTracked = false;
+
+	// Max craftable amount of every recipe, indexed like the compiled recipes of the inventory subsystem
+	TArray<int32> MaxCraftableAmounts;
+
+	// Recipes that can be crafted at least once
+	TBitArray<> CraftableRecipes;
+
+	// Held items returned by GetAllItemsOnInventory, built for the inventory version ItemsSnapshotVersion
+	mutable TMap<FGameplayTag, float> ItemsSnapshot;
+
+	mutable int32 ItemsSnapshotVersion = INDEX_NONE;
+
+	// Keeps a copy of the held items indexed by dense item ids, which speeds up crafting queries at the cost of memory per inventory
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Defaults")
+	bool bUseDenseItemStorage = false;
+
+	// Timed crafting jobs of the inventory, run by the crafting scheduler of the world
+	UPROPERTY(ReplicatedUsing = OnRep_CraftingJobs)
+	TArray<FGCCraftingJob> CraftingJobs;
+
+	// Maximum number of crafting jobs queued at once, 0 means no limit
+	UPROPERTY(EditDefaultsOnly, Category = "InventoryComponent|Crafting", meta = (ClampMin = 0))
+	int32 MaxCraftingJobs = 0;
 };
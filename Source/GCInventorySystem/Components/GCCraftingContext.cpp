@@ -0,0 +1,213 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCCraftingContext.h"
+#include "GCActorInventoryComponent.h"
+#include "Subsystems/GCInventoryGISSubsystems.h"
+#include "Modules/GCInventorySystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Inventory CraftItemFromSources"), STAT_GCInventory_CraftItemFromSources, STATGROUP_GCInventory);
+
+FGCCraftingContext::FGCCraftingContext(TConstArrayView<UGCActorInventoryComponent*> sources)
+{
+	for (const auto source : sources)
+	{
+		AddSource(source);
+	}
+}
+
+void FGCCraftingContext::AddSource(UGCActorInventoryComponent* source)
+{
+	if (source && !Sources.Contains(source))
+	{
+		Sources.Add(source);
+		MutableSources.Add(source);
+	}
+}
+
+void FGCCraftingContext::AddReadOnlySource(const UGCActorInventoryComponent* source)
+{
+	if (source)
+	{
+		Sources.AddUnique(source);
+	}
+}
+
+float FGCCraftingContext::GetItemStack(const FGameplayTag& itemTag) const
+{
+	float itemStack = 0.f;
+
+	for (const auto source : Sources)
+	{
+		itemStack += source->GetItemStack(itemTag);
+	}
+
+	return itemStack;
+}
+
+bool FGCCraftingContext::IsItemCraftable(TConstArrayView<FGCRecipeIngredient> ingredients) const
+{
+	if (ingredients.Num() == 0)
+	{
+		return false;
+	}
+
+	for (const auto& ingredient : ingredients)
+	{
+		if (GetItemStack(ingredient.ItemTag) < ingredient.Amount)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32 FGCCraftingContext::ComputeMaxCraftableAmount(TConstArrayView<FGCRecipeIngredient> ingredients) const
+{
+	// same rules as UGCActorInventoryComponent::ComputeMaxCraftableAmount over the summed stacks
+	int32 maxCraftable = MAX_int32;
+
+	for (const auto& ingredient : ingredients)
+	{
+		if (ingredient.Amount <= 0.f)
+		{
+			continue;
+		}
+
+		const int32 maxPerIngredient = static_cast<int32>(GetItemStack(ingredient.ItemTag) / ingredient.Amount);
+
+		if (maxPerIngredient < maxCraftable)
+		{
+			maxCraftable = maxPerIngredient;
+
+			if (maxCraftable <= 0)
+			{
+				return 0;
+			}
+		}
+	}
+
+	return maxCraftable != MAX_int32 ? maxCraftable : 0;
+}
+
+int32 FGCCraftingContext::FindMaxCraftableAmount(const FGameplayTag& itemTag) const
+{
+	if (Sources.Num() > 0)
+	{
+		if (const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(Sources[0]))
+		{
+			if (const auto itemRecipe = inventorySubsystem->FindCompiledRecipe(itemTag))
+			{
+				return ComputeMaxCraftableAmount(inventorySubsystem->GetRecipeIngredients(*itemRecipe));
+			}
+		}
+	}
+
+	return 0;
+}
+
+int32 FGCCraftingContext::CraftItem(const FGameplayTag& itemTag, int32 count /*= 1*/)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_CraftItemFromSources);
+	CSV_SCOPED_TIMING_STAT(GCInventory, CraftItemFromSources);
+
+	if (Sources.Num() == 0 || count <= 0)
+	{
+		return 0;
+	}
+
+	if (!CanCraft())
+	{
+		UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Cannot craft %s, the crafting context holds read-only sources"), ANSI_TO_TCHAR(__FUNCTION__), *itemTag.ToString());
+		return 0;
+	}
+
+	const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(Sources[0]);
+	const auto itemRecipe = inventorySubsystem ? inventorySubsystem->FindCompiledRecipe(itemTag) : nullptr;
+
+	if (!itemRecipe)
+	{
+		return 0;
+	}
+
+	const auto ingredients = inventorySubsystem->GetRecipeIngredients(*itemRecipe);
+	const int32 maxCraftable = ComputeMaxCraftableAmount(ingredients);
+	const int32 numCrafts = FMath::Min(count, maxCraftable);
+
+	if (numCrafts <= 0)
+	{
+		return 0;
+	}
+
+	// every ingredient is drained from the first source holding it, then the next one, so the same context always takes the same items
+	TArray<FGCInventoryDelta, TInlineAllocator<4>> sourceDeltas;
+	sourceDeltas.SetNum(Sources.Num());
+
+	for (const auto& ingredient : ingredients)
+	{
+		float remainingAmount = numCrafts * ingredient.Amount;
+
+		for (int32 sourceIndex = 0; sourceIndex < Sources.Num() && remainingAmount > 0.f; ++sourceIndex)
+		{
+			const float takenAmount = FMath::Min(remainingAmount, Sources[sourceIndex]->GetItemStack(ingredient.ItemTag));
+
+			if (takenAmount > 0.f)
+			{
+				sourceDeltas[sourceIndex].ItemsToRemove.FindOrAdd(ingredient.ItemTag) += takenAmount;
+				remainingAmount -= takenAmount;
+			}
+		}
+	}
+
+	const float craftedQuantity = numCrafts * itemRecipe->CraftedQuantity;
+	sourceDeltas[0].ItemsToAdd.Add(itemTag, craftedQuantity);
+
+	// every delta is validated before any of them is applied, so the sources are never left half drained
+	for (int32 sourceIndex = 0; sourceIndex < Sources.Num(); ++sourceIndex)
+	{
+		if (!sourceDeltas[sourceIndex].IsEmpty() && !MutableSources[sourceIndex]->CanApplyInventoryDelta(sourceDeltas[sourceIndex]))
+		{
+			UE_LOG(LogInventorySystem, Verbose, TEXT("[%s] Source %d cannot give its share of the ingredients of %s"), ANSI_TO_TCHAR(__FUNCTION__), sourceIndex, *itemTag.ToString());
+			return 0;
+		}
+	}
+
+	for (int32 sourceIndex = 0; sourceIndex < Sources.Num(); ++sourceIndex)
+	{
+		if (sourceDeltas[sourceIndex].IsEmpty() || MutableSources[sourceIndex]->ApplyInventoryDelta(sourceDeltas[sourceIndex]))
+		{
+			continue;
+		}
+
+		// a listener of an earlier source changed this one, the sources already changed are given back what they gave
+		UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Source %d rejected its share of the ingredients of %s, rolling back the craft"), ANSI_TO_TCHAR(__FUNCTION__), sourceIndex, *itemTag.ToString());
+
+		for (int32 appliedIndex = sourceIndex - 1; appliedIndex >= 0; --appliedIndex)
+		{
+			if (sourceDeltas[appliedIndex].IsEmpty())
+			{
+				continue;
+			}
+
+			FGCInventoryDelta rollbackDelta;
+			rollbackDelta.ItemsToAdd = sourceDeltas[appliedIndex].ItemsToRemove;
+			rollbackDelta.ItemsToRemove = sourceDeltas[appliedIndex].ItemsToAdd;
+
+			if (!MutableSources[appliedIndex]->ApplyInventoryDelta(rollbackDelta))
+			{
+				UE_LOG(LogInventorySystem, Error, TEXT("[%s] Source %d could not be rolled back after crafting %s"), ANSI_TO_TCHAR(__FUNCTION__), appliedIndex, *itemTag.ToString());
+			}
+		}
+
+		return 0;
+	}
+
+	const auto crafter = MutableSources[0];
+
+	if (const auto ownerActor = crafter->GetInventoryInterfaceOwner())
+	{
+		crafter->NotifyItemCrafted(ownerActor, itemTag, craftedQuantity);
+	}
+
+	return numCrafts;
+}
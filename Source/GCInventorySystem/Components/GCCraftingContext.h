@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Types/InventoryTypes.h"
+
+class UGCActorInventoryComponent;
+
+/**
+ * Ordered set of inventories crafting together, for example a backpack and the storage chests around it.
+ * Stacks are summed across the sources on every query, the inventories are never merged or copied.
+ * Ingredients are drained from the sources in order and the crafted items go to the first source.
+ * Meant to live on the stack while crafting, it does not keep the sources alive.
+ */
+class GCINVENTORYSYSTEM_API FGCCraftingContext
+{
+public:
+
+	FGCCraftingContext() = default;
+
+	explicit FGCCraftingContext(TConstArrayView<UGCActorInventoryComponent*> sources);
+
+	// Adds a source after the current ones. Null and repeated sources are ignored so stacks are never counted twice.
+	void AddSource(UGCActorInventoryComponent* source);
+
+	// Adds a source that is only queried, for const callers. A context holding a read-only source cannot craft.
+	void AddReadOnlySource(const UGCActorInventoryComponent* source);
+
+	TConstArrayView<const UGCActorInventoryComponent*> GetSources() const
+	{
+		return Sources;
+	}
+
+	bool CanCraft() const
+	{
+		return MutableSources.Num() == Sources.Num();
+	}
+
+	// Returns the stack of the item summed across every source
+	float GetItemStack(const FGameplayTag& itemTag) const;
+
+	bool IsItemCraftable(TConstArrayView<FGCRecipeIngredient> ingredients) const;
+
+	// Returns how many times the ingredients can be taken from the sources, computed in a single pass
+	int32 ComputeMaxCraftableAmount(TConstArrayView<FGCRecipeIngredient> ingredients) const;
+
+	int32 FindMaxCraftableAmount(const FGameplayTag& itemTag) const;
+
+	// Crafts the item up to count times, fewer if the ingredients run out and none if count <= 0. Either every source is changed or none.
+	// Returns how many times it was crafted. Pass MAX_int32 to craft as many times as possible. Crafts nothing if a source is read-only.
+	int32 CraftItem(const FGameplayTag& itemTag, int32 count = 1);
+
+private:
+
+	// Every source in order, used by the queries
+	TArray<const UGCActorInventoryComponent*, TInlineAllocator<4>> Sources;
+
+	// Same sources as Sources when none of them is read-only, used to apply the crafts
+	TArray<UGCActorInventoryComponent*, TInlineAllocator<4>> MutableSources;
+};
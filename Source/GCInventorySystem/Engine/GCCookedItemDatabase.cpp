@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCCookedItemDatabase.h"
+#include "GCInventoryMappingDataAsset.h"
+#include "Modules/GCInventorySystem.h"
+#include <GameplayTagsManager.h>
+#include <Engine/DataTable.h>
+#include <HAL/PlatformFileManager.h>
+#include <Async/MappedFileHandle.h>
+#include <Misc/FileHelper.h>
+#include <Algo/BinarySearch.h>
+
+namespace GCCookedItemDatabase
+{
+	bool TryGetNetIndex(const FGameplayTag& tag, uint16& outNetIndex)
+	{
+		const auto& tagsManager = UGameplayTagsManager::Get();
+		outNetIndex = tagsManager.GetNetIndexFromTag(tag);
+		return outNetIndex != tagsManager.GetInvalidTagNetIndex();
+	}
+
+	void GatherItemsTable(const FGameplayTag& categoryTag, const UDataTable* itemsTable, TMap<FGameplayTag, FGameplayTag>& outItemCategories)
+	{
+		for (const auto& tableRow : itemsTable->GetRowMap())
+		{
+			outItemCategories.Add(FGameplayTag::RequestGameplayTag(tableRow.Key), categoryTag);
+		}
+	}
+}
+
+FGCCookedItemDatabase::FGCCookedItemDatabase()
+{
+}
+
+FGCCookedItemDatabase::~FGCCookedItemDatabase()
+{
+	Close();
+}
+
+bool FGCCookedItemDatabase::Write(const UGCInventoryMappingDataAsset& dataAsset, const FString& filename)
+{
+	TMap<FGameplayTag, FGameplayTag> itemCategories;
+
+	for (const auto& itemCategory : dataAsset.ItemsCategoryMap)
+	{
+		if (itemCategory.Value)
+		{
+			GCCookedItemDatabase::GatherItemsTable(itemCategory.Key, itemCategory.Value, itemCategories);
+		}
+	}
+
+	for (const auto& itemCategory : dataAsset.OnDemandItemsCategoryMap)
+	{
+		if (const auto itemsTable = itemCategory.Value.LoadSynchronous())
+		{
+			GCCookedItemDatabase::GatherItemsTable(itemCategory.Key, itemsTable, itemCategories);
+		}
+		else
+		{
+			UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to load the items table of the on demand category: %s"), ANSI_TO_TCHAR(__FUNCTION__), *itemCategory.Key.ToString());
+			return false;
+		}
+	}
+
+	TArray<FGCCookedItemEntry> items;
+	TArray<FGCCookedRecipeIngredient> ingredients;
+	items.Reserve(itemCategories.Num());
+
+	FGCCookedItemDatabaseHeader header;
+
+	for (const auto& itemCategory : itemCategories)
+	{
+		FGCCookedItemEntry& item = items.AddDefaulted_GetRef();
+
+		if (!GCCookedItemDatabase::TryGetNetIndex(itemCategory.Key, item.ItemNetIndex) || !GCCookedItemDatabase::TryGetNetIndex(itemCategory.Value, item.CategoryNetIndex))
+		{
+			UE_LOG(LogInventorySystem, Error, TEXT("[%s] Item %s has no gameplay tag net index."), ANSI_TO_TCHAR(__FUNCTION__), *itemCategory.Key.ToString());
+			return false;
+		}
+
+		// same lookup as UGCInventoryGISSubsystems::GetItemRecipe, the recipe must live under the category of the item
+		const auto recipeCategory = dataAsset.ItemsCategoryCraftingRecipes.Find(itemCategory.Value);
+		const auto itemRecipe = recipeCategory ? recipeCategory->ItemRecipes.Find(itemCategory.Key) : nullptr;
+
+		if (itemRecipe)
+		{
+			item.FirstIngredient = ingredients.Num();
+			item.NumIngredients = itemRecipe->RecipeElements.Num();
+			item.CraftedQuantity = itemRecipe->CraftedQuantity;
+			item.CraftingTime = itemRecipe->CraftingTime;
+
+			for (const auto& recipeElement : itemRecipe->RecipeElements)
+			{
+				FGCCookedRecipeIngredient& ingredient = ingredients.AddDefaulted_GetRef();
+				ingredient.Amount = recipeElement.Value;
+
+				if (!GCCookedItemDatabase::TryGetNetIndex(recipeElement.Key, ingredient.ItemNetIndex))
+				{
+					UE_LOG(LogInventorySystem, Error, TEXT("[%s] Ingredient %s has no gameplay tag net index."), ANSI_TO_TCHAR(__FUNCTION__), *recipeElement.Key.ToString());
+					return false;
+				}
+			}
+
+			++header.NumRecipes;
+		}
+	}
+
+	items.Sort([](const FGCCookedItemEntry& a, const FGCCookedItemEntry& b)
+		{
+			return a.ItemNetIndex < b.ItemNetIndex;
+		});
+
+	header.TagDictionaryHash = UGameplayTagsManager::Get().GetNetworkGameplayTagNodeIndexHash();
+	header.NumItems = items.Num();
+	header.NumIngredients = ingredients.Num();
+	header.ItemsOffset = sizeof(FGCCookedItemDatabaseHeader);
+	header.IngredientsOffset = header.ItemsOffset + items.Num() * sizeof(FGCCookedItemEntry);
+
+	TArray<uint8> fileData;
+	fileData.Reserve(header.IngredientsOffset + ingredients.Num() * sizeof(FGCCookedRecipeIngredient));
+	fileData.Append(reinterpret_cast<const uint8*>(&header), sizeof(FGCCookedItemDatabaseHeader));
+	fileData.Append(reinterpret_cast<const uint8*>(items.GetData()), items.Num() * sizeof(FGCCookedItemEntry));
+	fileData.Append(reinterpret_cast<const uint8*>(ingredients.GetData()), ingredients.Num() * sizeof(FGCCookedRecipeIngredient));
+
+	if (!FFileHelper::SaveArrayToFile(fileData, *filename))
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to write the cooked item database to %s"), ANSI_TO_TCHAR(__FUNCTION__), *filename);
+		return false;
+	}
+
+	UE_LOG(LogInventorySystem, Display, TEXT("[%s] Cooked %d items and %d recipes to %s"), ANSI_TO_TCHAR(__FUNCTION__), header.NumItems, header.NumRecipes, *filename);
+	return true;
+}
+
+bool FGCCookedItemDatabase::Open(const FString& filename)
+{
+	Close();
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*filename));
+
+	if (MappedFile.IsValid())
+	{
+		MappedRegion.Reset(MappedFile->MapRegion());
+	}
+
+	if (!MappedRegion.IsValid())
+	{
+		UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Could not memory map the cooked item database %s. Packaged builds must stage it as a loose file, see DirectoriesToAlwaysStageAsNonUFS."), ANSI_TO_TCHAR(__FUNCTION__), *filename);
+		Close();
+		return false;
+	}
+
+	const uint8* fileData = MappedRegion->GetMappedPtr();
+	const uint64 fileSize = MappedRegion->GetMappedSize();
+	const auto fileHeader = reinterpret_cast<const FGCCookedItemDatabaseHeader*>(fileData);
+
+	const bool bValidHeader = fileSize >= sizeof(FGCCookedItemDatabaseHeader)
+		&& fileHeader->Magic == FGCCookedItemDatabaseHeader::ExpectedMagic
+		&& fileHeader->Version == FGCCookedItemDatabaseHeader::ExpectedVersion
+		&& uint64(fileHeader->ItemsOffset) + uint64(fileHeader->NumItems) * sizeof(FGCCookedItemEntry) <= fileSize
+		&& uint64(fileHeader->IngredientsOffset) + uint64(fileHeader->NumIngredients) * sizeof(FGCCookedRecipeIngredient) <= fileSize;
+
+	if (!bValidHeader)
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] The cooked item database %s is malformed or outdated."), ANSI_TO_TCHAR(__FUNCTION__), *filename);
+		Close();
+		return false;
+	}
+
+	if (fileHeader->TagDictionaryHash != UGameplayTagsManager::Get().GetNetworkGameplayTagNodeIndexHash())
+	{
+		UE_LOG(LogInventorySystem, Warning, TEXT("[%s] The cooked item database %s was cooked with different gameplay tags. Please cook it again."), ANSI_TO_TCHAR(__FUNCTION__), *filename);
+		Close();
+		return false;
+	}
+
+	const auto fileItems = MakeArrayView(reinterpret_cast<const FGCCookedItemEntry*>(fileData + fileHeader->ItemsOffset), fileHeader->NumItems);
+
+	// GetIngredients slices the ingredients block with the ranges of the entries and FindItem binary searches them, so both are checked once here
+	for (int32 itemIndex = 0; itemIndex < fileItems.Num(); ++itemIndex)
+	{
+		const auto& fileItem = fileItems[itemIndex];
+
+		const bool bValidIngredients = fileItem.FirstIngredient == INDEX_NONE
+			|| (fileItem.FirstIngredient >= 0 && fileItem.NumIngredients >= 0 && int64(fileItem.FirstIngredient) + fileItem.NumIngredients <= int64(fileHeader->NumIngredients));
+
+		if (!bValidIngredients || (itemIndex > 0 && fileItems[itemIndex - 1].ItemNetIndex >= fileItem.ItemNetIndex))
+		{
+			UE_LOG(LogInventorySystem, Error, TEXT("[%s] The cooked item database %s is malformed, its item %d is out of order or out of the ingredients block."), ANSI_TO_TCHAR(__FUNCTION__), *filename, itemIndex);
+			Close();
+			return false;
+		}
+	}
+
+	Header = fileHeader;
+	Items = fileItems;
+	Ingredients = MakeArrayView(reinterpret_cast<const FGCCookedRecipeIngredient*>(fileData + fileHeader->IngredientsOffset), fileHeader->NumIngredients);
+
+	return true;
+}
+
+void FGCCookedItemDatabase::Close()
+{
+	Header = nullptr;
+	Items = TConstArrayView<FGCCookedItemEntry>();
+	Ingredients = TConstArrayView<FGCCookedRecipeIngredient>();
+
+	// the region has to be released before the file handle
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+const FGCCookedItemEntry* FGCCookedItemDatabase::FindItem(const FGameplayTag& itemTag) const
+{
+	uint16 netIndex = 0;
+
+	if (!IsOpen() || !GCCookedItemDatabase::TryGetNetIndex(itemTag, netIndex))
+	{
+		return nullptr;
+	}
+
+	const int32 itemIndex = Algo::BinarySearchBy(Items, netIndex, &FGCCookedItemEntry::ItemNetIndex);
+
+	return itemIndex != INDEX_NONE ? &Items[itemIndex] : nullptr;
+}
+
+FGameplayTag FGCCookedItemDatabase::GetTagFromNetIndex(uint16 netIndex)
+{
+	// the node of the net index holds its tag, so no name has to be looked up
+	const auto& networkTagNodes = UGameplayTagsManager::Get().GetNetworkGameplayTagNodeIndex();
+
+	return networkTagNodes.IsValidIndex(netIndex) && networkTagNodes[netIndex].IsValid() ? networkTagNodes[netIndex]->GetCompleteTag() : FGameplayTag();
+}
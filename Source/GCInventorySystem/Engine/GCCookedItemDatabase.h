@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+class UGCInventoryMappingDataAsset;
+
+// Header of the cooked item database file
+struct FGCCookedItemDatabaseHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x42444347; // "GCDB"
+	static constexpr uint32 ExpectedVersion = 2;
+
+	uint32 Magic = ExpectedMagic;
+
+	uint32 Version = ExpectedVersion;
+
+	// Hash of the gameplay tag net indices the database was cooked with
+	uint32 TagDictionaryHash = 0;
+
+	uint32 NumItems = 0;
+
+	uint32 NumRecipes = 0;
+
+	uint32 NumIngredients = 0;
+
+	uint32 ItemsOffset = 0;
+
+	uint32 IngredientsOffset = 0;
+};
+
+// Item of the cooked item database. Items are sorted by their tag net index.
+struct FGCCookedItemEntry
+{
+	uint16 ItemNetIndex = 0;
+
+	uint16 CategoryNetIndex = 0;
+
+	// First ingredient of the item recipe inside the ingredients block, INDEX_NONE if the item cannot be crafted
+	int32 FirstIngredient = INDEX_NONE;
+
+	int32 NumIngredients = 0;
+
+	float CraftedQuantity = 0.f;
+
+	float CraftingTime = 0.f;
+};
+
+struct FGCCookedRecipeIngredient
+{
+	uint16 ItemNetIndex = 0;
+
+	uint16 Padding = 0;
+
+	float Amount = 0.f;
+};
+
+/**
+ * Flat, sorted binary image of the items and recipes of a UGCInventoryMappingDataAsset.
+ * The file is memory mapped read only, so lookups never build maps and server processes on the same host share its pages.
+ * Tags are stored as gameplay tag net indices, so the database must be cooked with the same tag dictionary the game runs with.
+ */
+class GCINVENTORYSYSTEM_API FGCCookedItemDatabase
+{
+public:
+
+	FGCCookedItemDatabase();
+	~FGCCookedItemDatabase();
+
+	// Bakes the items and recipes of the data asset into the file. Loads every category table, meant to be run by the cook commandlet.
+	static bool Write(const UGCInventoryMappingDataAsset& dataAsset, const FString& filename);
+
+	// Memory maps the file. Fails if it is missing, malformed or was cooked with a different gameplay tag dictionary.
+	bool Open(const FString& filename);
+
+	void Close();
+
+	bool IsOpen() const
+	{
+		return Header != nullptr;
+	}
+
+	// Binary searches the item, returns nullptr if the database does not know it
+	const FGCCookedItemEntry* FindItem(const FGameplayTag& itemTag) const;
+
+	TConstArrayView<FGCCookedItemEntry> GetItems() const
+	{
+		return Items;
+	}
+
+	TConstArrayView<FGCCookedRecipeIngredient> GetIngredients(const FGCCookedItemEntry& item) const
+	{
+		return item.FirstIngredient != INDEX_NONE ? Ingredients.Slice(item.FirstIngredient, item.NumIngredients) : TConstArrayView<FGCCookedRecipeIngredient>();
+	}
+
+	const FGCCookedItemDatabaseHeader* GetHeader() const
+	{
+		return Header;
+	}
+
+	// Returns the tag of the net index straight from the tag nodes, without looking its name up
+	static FGameplayTag GetTagFromNetIndex(uint16 netIndex);
+
+private:
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	const FGCCookedItemDatabaseHeader* Header = nullptr;
+
+	TConstArrayView<FGCCookedItemEntry> Items;
+
+	TConstArrayView<FGCCookedRecipeIngredient> Ingredients;
+};
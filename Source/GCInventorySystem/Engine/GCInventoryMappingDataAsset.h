@@ -26,6 +26,10 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	TMap<FGameplayTag, UDataTable*> ItemsCategoryMap;
 
+	// Categories whose table is only loaded when one of its items is queried. Every item tag of these tables must be a child of the category tag.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TMap<FGameplayTag, TSoftObjectPtr<UDataTable>> OnDemandItemsCategoryMap;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	TMap<FGameplayTag, FItemRecipeInfo> ItemsCategoryCraftingRecipes;
 	
@@ -8,6 +8,9 @@ public class GCInventorySystem : ModuleRules
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
 
+		// the tag stacks provide their own Iris serializer
+		SetupIrisSupport(Target);
+
         PublicIncludePaths.Add(ModuleDirectory);
         PrivateIncludePaths.Add(ModuleDirectory);
 
@@ -44,7 +47,8 @@ public class GCInventorySystem : ModuleRules
 				"Slate",
 				"SlateCore",
                 "GameplayTags",
-                "NetCore"
+                "NetCore",
+                "Json"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -12,6 +12,8 @@
 
 DEFINE_LOG_CATEGORY(LogInventorySystem);
 
+CSV_DEFINE_CATEGORY_MODULE(GCINVENTORYSYSTEM_API, GCInventory, true);
+
 void FGCInventorySystemModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
@@ -4,9 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
 GCINVENTORYSYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(LogInventorySystem, Log, All);
 
+// Timings of the inventory operations, shown with "stat GCInventory" and recorded by the CSV profiler under the GCInventory category
+DECLARE_STATS_GROUP(TEXT("GCInventory"), STATGROUP_GCInventory, STATCAT_Advanced);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GCINVENTORYSYSTEM_API, GCInventory);
+
 class FGCInventorySystemModule : public IModuleInterface
 {
 public:
@@ -0,0 +1,258 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCCraftingSchedulerSubsystem.h"
+#include "GCInventoryGISSubsystems.h"
+#include "Components/GCActorInventoryComponent.h"
+#include "Modules/GCInventorySystem.h"
+#include <Engine/Engine.h>
+#include <Engine/World.h>
+
+DECLARE_CYCLE_STAT(TEXT("Inventory CompleteCrafts"), STAT_GCInventory_CompleteCrafts, STATGROUP_GCInventory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Scheduled Crafting Jobs"), STAT_GCInventory_ScheduledCraftingJobs, STATGROUP_GCInventory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Completed Crafting Jobs"), STAT_GCInventory_CompletedCraftingJobs, STATGROUP_GCInventory);
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GCCraftingSchedulerSubsystem)
+
+UGCCraftingSchedulerSubsystem* UGCCraftingSchedulerSubsystem::Get(const UObject* worldContextObject)
+{
+	if (const auto world = GEngine->GetWorldFromContextObject(worldContextObject, EGetWorldErrorMode::LogAndReturnNull))
+	{
+		return world->GetSubsystem<UGCCraftingSchedulerSubsystem>();
+	}
+
+	return nullptr;
+}
+
+void UGCCraftingSchedulerSubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	TickInterval = FMath::Max(GetDefault<UGCInventoryGISSubsystems>()->GetCraftingSchedulerTickInterval(), 0.01f);
+}
+
+void UGCCraftingSchedulerSubsystem::Deinitialize()
+{
+	TimingWheel.Reset();
+	ScheduledJobs.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGCCraftingSchedulerSubsystem::Tick(float deltaTime)
+{
+	Super::Tick(deltaTime);
+
+	const uint64 targetTick = static_cast<uint64>(GetCurrentTime() / TickInterval);
+
+	if (targetTick > TimingWheel.GetCurrentTick())
+	{
+		ExpiredJobIds.Reset();
+		TimingWheel.Advance(targetTick, ExpiredJobIds);
+
+		if (ExpiredJobIds.Num() > 0)
+		{
+			CompleteCrafts(ExpiredJobIds);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_GCInventory_ScheduledCraftingJobs, ScheduledJobs.Num());
+	CSV_CUSTOM_STAT(GCInventory, ScheduledCraftingJobs, ScheduledJobs.Num(), ECsvCustomStatOp::Set);
+}
+
+TStatId UGCCraftingSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCCraftingSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+bool UGCCraftingSchedulerSubsystem::DoesSupportWorldType(const EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+int32 UGCCraftingSchedulerSubsystem::QueueCraft(UGCActorInventoryComponent* inventory, const FGameplayTag& itemTag)
+{
+	if (!inventory || inventory->GetOwnerRole() != ROLE_Authority)
+	{
+		return INDEX_NONE;
+	}
+
+	if (inventory->MaxCraftingJobs > 0 && inventory->CraftingJobs.Num() >= inventory->MaxCraftingJobs)
+	{
+		UE_LOG(LogInventorySystem, Verbose, TEXT("[%s] The crafting queue of %s is full"), ANSI_TO_TCHAR(__FUNCTION__), *GetNameSafe(inventory->GetOwner()));
+		return INDEX_NONE;
+	}
+
+	const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(inventory);
+	const auto itemRecipe = inventorySubsystem->FindCompiledRecipe(itemTag);
+
+	// the ingredients are reserved by taking them right away, a cancelled job gives them back
+	TMap<FGameplayTag, float> reservedItems;
+	if (!itemRecipe || !inventory->ConsumeItemRecipe(itemTag, &reservedItems))
+	{
+		return INDEX_NONE;
+	}
+
+	FGCCraftingJob& craftingJob = inventory->CraftingJobs.AddDefaulted_GetRef();
+	craftingJob.JobId = NextJobId++;
+	craftingJob.ItemTag = itemTag;
+	craftingJob.Duration = itemRecipe->CraftingTime;
+	craftingJob.ReservedItems = MoveTemp(reservedItems);
+
+	const int32 jobId = craftingJob.JobId;
+
+	StartNextCraft(inventory, GetCurrentTime());
+
+	inventory->MarkCraftingJobsDirty();
+
+	return jobId;
+}
+
+bool UGCCraftingSchedulerSubsystem::CancelCraft(UGCActorInventoryComponent* inventory, int32 jobId)
+{
+	if (!inventory || inventory->GetOwnerRole() != ROLE_Authority)
+	{
+		return false;
+	}
+
+	const int32 jobIndex = inventory->CraftingJobs.IndexOfByPredicate([jobId](const FGCCraftingJob& craftingJob)
+		{
+			return craftingJob.JobId == jobId;
+		});
+
+	if (jobIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FGCScheduledCraftingJob scheduledJob;
+
+	if (ScheduledJobs.RemoveAndCopyValue(jobId, scheduledJob))
+	{
+		TimingWheel.Cancel(scheduledJob.TimerIndex);
+	}
+
+	// exactly what was reserved is given back, whatever the recipe looks like now
+	const FGCCraftingJob cancelledJob = MoveTemp(inventory->CraftingJobs[jobIndex]);
+	inventory->CraftingJobs.RemoveAt(jobIndex);
+
+	RefundReservedItems(inventory, cancelledJob);
+
+	StartNextCraft(inventory, GetCurrentTime());
+
+	inventory->MarkCraftingJobsDirty();
+
+	return true;
+}
+
+void UGCCraftingSchedulerSubsystem::RemoveInventoryJobs(UGCActorInventoryComponent* inventory)
+{
+	if (!inventory || inventory->CraftingJobs.Num() == 0)
+	{
+		return;
+	}
+
+	FGCScheduledCraftingJob scheduledJob;
+
+	if (ScheduledJobs.RemoveAndCopyValue(inventory->CraftingJobs[0].JobId, scheduledJob))
+	{
+		TimingWheel.Cancel(scheduledJob.TimerIndex);
+	}
+}
+
+void UGCCraftingSchedulerSubsystem::StartNextCraft(UGCActorInventoryComponent* inventory, double startTime)
+{
+	if (inventory->CraftingJobs.Num() == 0 || inventory->CraftingJobs[0].IsStarted())
+	{
+		return;
+	}
+
+	FGCCraftingJob& craftingJob = inventory->CraftingJobs[0];
+	craftingJob.StartTime = startTime;
+
+	const uint64 expireTick = static_cast<uint64>(FMath::CeilToDouble((startTime + craftingJob.Duration) / TickInterval));
+
+	FGCScheduledCraftingJob& scheduledJob = ScheduledJobs.Add(craftingJob.JobId);
+	scheduledJob.Inventory = inventory;
+	scheduledJob.TimerIndex = TimingWheel.Schedule(expireTick, craftingJob.JobId);
+}
+
+void UGCCraftingSchedulerSubsystem::CompleteCrafts(TConstArrayView<int32> jobIds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_CompleteCrafts);
+	CSV_SCOPED_TIMING_STAT(GCInventory, CompleteCrafts);
+
+	const auto inventorySubsystem = UGCInventoryGISSubsystems::Get(this);
+
+	// inventories are marked dirty once all the jobs of the tick are completed
+	TSet<UGCActorInventoryComponent*, DefaultKeyFuncs<UGCActorInventoryComponent*>, TInlineSetAllocator<16>> changedInventories;
+
+	for (const int32 jobId : jobIds)
+	{
+		FGCScheduledCraftingJob scheduledJob;
+
+		if (!ScheduledJobs.RemoveAndCopyValue(jobId, scheduledJob))
+		{
+			continue;
+		}
+
+		const auto inventory = scheduledJob.Inventory.Get();
+
+		if (!inventory || inventory->CraftingJobs.Num() == 0 || inventory->CraftingJobs[0].JobId != jobId)
+		{
+			continue;
+		}
+
+		const FGCCraftingJob completedJob = inventory->CraftingJobs[0];
+		inventory->CraftingJobs.RemoveAt(0);
+
+		const auto itemRecipe = inventorySubsystem->FindCompiledRecipe(completedJob.ItemTag);
+
+		if (itemRecipe && inventory->AddItemToInventory(completedJob.ItemTag, itemRecipe->CraftedQuantity))
+		{
+			inventory->NotifyItemCrafted(inventory->GetOwner(), completedJob.ItemTag, itemRecipe->CraftedQuantity);
+		}
+		else
+		{
+			// the recipe went away (items reloaded in the editor) or the item could not be granted, the ingredients must not be lost
+			UE_LOG(LogInventorySystem, Error, TEXT("[%s] Could not grant the crafted item %s to %s, its ingredients are given back"), ANSI_TO_TCHAR(__FUNCTION__), *completedJob.ItemTag.ToString(), *GetNameSafe(inventory->GetOwner()));
+			RefundReservedItems(inventory, completedJob);
+		}
+
+		// the next job starts when this one was due, so a late tick does not delay the whole queue
+		StartNextCraft(inventory, completedJob.StartTime + completedJob.Duration);
+
+		changedInventories.Add(inventory);
+	}
+
+	for (const auto inventory : changedInventories)
+	{
+		inventory->MarkCraftingJobsDirty();
+	}
+
+	INC_DWORD_STAT_BY(STAT_GCInventory_CompletedCraftingJobs, jobIds.Num());
+}
+
+bool UGCCraftingSchedulerSubsystem::RefundReservedItems(UGCActorInventoryComponent* inventory, const FGCCraftingJob& craftingJob)
+{
+	if (craftingJob.ReservedItems.Num() == 0)
+	{
+		return true;
+	}
+
+	// a single delta, so the refund costs one replication update
+	FGCInventoryDelta refundDelta;
+	refundDelta.ItemsToAdd = craftingJob.ReservedItems;
+
+	if (!inventory->ApplyInventoryDelta(refundDelta))
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to give back the ingredients of the crafting job %d (%s) to %s"), ANSI_TO_TCHAR(__FUNCTION__), craftingJob.JobId, *craftingJob.ItemTag.ToString(), *GetNameSafe(inventory->GetOwner()));
+		return false;
+	}
+
+	return true;
+}
+
+double UGCCraftingSchedulerSubsystem::GetCurrentTime() const
+{
+	return GetWorld()->GetTimeSeconds();
+}
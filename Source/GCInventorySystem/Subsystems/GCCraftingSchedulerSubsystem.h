@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "System/GCTimingWheel.h"
+#include "Types/InventoryTypes.h"
+
+#include "GCCraftingSchedulerSubsystem.generated.h"
+
+class UGCActorInventoryComponent;
+
+// Crafting job waiting for its timer in the scheduler
+struct FGCScheduledCraftingJob
+{
+	TWeakObjectPtr<UGCActorInventoryComponent> Inventory;
+
+	int32 TimerIndex = INDEX_NONE;
+};
+
+/**
+ * Runs the timed crafting jobs of every inventory of the world on the server, see UGCActorInventoryComponent::QueueItemCraft.
+ * Every inventory crafts its jobs one after the other and only the job being crafted has a timer, kept in a single
+ * timing wheel so the cost per frame does not grow with the number of jobs. Expired jobs are completed together once per tick.
+ */
+UCLASS()
+class GCINVENTORYSYSTEM_API UGCCraftingSchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UGCCraftingSchedulerSubsystem* Get(const UObject* worldContextObject);
+
+	// Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem Interface
+
+	// Begin FTickableGameObject Interface
+	virtual void Tick(float deltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject Interface
+
+	// Takes the ingredients of the recipe from the inventory and queues the craft. Returns the id of the job, or INDEX_NONE if it could not be queued.
+	int32 QueueCraft(UGCActorInventoryComponent* inventory, const FGameplayTag& itemTag);
+
+	// Removes the job from the inventory and gives its ingredients back
+	bool CancelCraft(UGCActorInventoryComponent* inventory, int32 jobId);
+
+	// Stops the timer of the inventory without refunding anything, used when the inventory goes away
+	void RemoveInventoryJobs(UGCActorInventoryComponent* inventory);
+
+	int32 GetNumScheduledJobs() const
+	{
+		return ScheduledJobs.Num();
+	}
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type worldType) const override;
+
+	// Starts the first job of the inventory if it is waiting
+	void StartNextCraft(UGCActorInventoryComponent* inventory, double startTime);
+
+	void CompleteCrafts(TConstArrayView<int32> jobIds);
+
+	// Gives the ingredients reserved by the job back to the inventory. Returns false (and logs) if the inventory rejected them.
+	bool RefundReservedItems(UGCActorInventoryComponent* inventory, const FGCCraftingJob& craftingJob);
+
+	double GetCurrentTime() const;
+
+	FGCTimingWheel TimingWheel;
+
+	// Jobs being crafted, by job id
+	TMap<int32, FGCScheduledCraftingJob> ScheduledJobs;
+
+	TArray<int32> ExpiredJobIds;
+
+	float TickInterval = 0.1f;
+
+	int32 NextJobId = 0;
+};
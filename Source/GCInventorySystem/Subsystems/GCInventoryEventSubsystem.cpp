@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryEventSubsystem.h"
+#include "GCInventoryGISSubsystems.h"
+#include "Components/GCActorInventoryComponent.h"
+#include "Modules/GCInventorySystem.h"
+#include <Engine/Engine.h>
+#include <Engine/World.h>
+
+DECLARE_CYCLE_STAT(TEXT("Inventory DispatchItemEvents"), STAT_GCInventory_DispatchItemEvents, STATGROUP_GCInventory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Pending Item Events"), STAT_GCInventory_PendingItemEvents, STATGROUP_GCInventory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Dispatched Item Events"), STAT_GCInventory_DispatchedItemEvents, STATGROUP_GCInventory);
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GCInventoryEventSubsystem)
+
+UGCInventoryEventSubsystem* UGCInventoryEventSubsystem::Get(const UObject* worldContextObject)
+{
+	if (const auto world = GEngine->GetWorldFromContextObject(worldContextObject, EGetWorldErrorMode::LogAndReturnNull))
+	{
+		return world->GetSubsystem<UGCInventoryEventSubsystem>();
+	}
+
+	return nullptr;
+}
+
+void UGCInventoryEventSubsystem::Deinitialize()
+{
+	// the inventories are being torn down with the world, nobody is left to receive the events
+	if (GetNumPendingItemEvents() > 0)
+	{
+		UE_LOG(LogInventorySystem, Verbose, TEXT("[%s] Discarding %d pending item events"), ANSI_TO_TCHAR(__FUNCTION__), GetNumPendingItemEvents());
+	}
+
+	PendingItemEvents.Empty();
+	FirstPendingItemEvent = 0;
+	NumPendingItemEventsPerInventory.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGCInventoryEventSubsystem::Tick(float deltaTime)
+{
+	Super::Tick(deltaTime);
+
+	if (GetNumPendingItemEvents() > 0)
+	{
+		const float frameBudgetMs = GetDefault<UGCInventoryGISSubsystems>()->GetDeferredItemEventsFrameBudgetMs();
+
+		DispatchItemEvents(frameBudgetMs > 0.f ? frameBudgetMs * 0.001 : TNumericLimits<double>::Max());
+	}
+
+	SET_DWORD_STAT(STAT_GCInventory_PendingItemEvents, GetNumPendingItemEvents());
+	CSV_CUSTOM_STAT(GCInventory, PendingItemEvents, GetNumPendingItemEvents(), ECsvCustomStatOp::Set);
+}
+
+TStatId UGCInventoryEventSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCInventoryEventSubsystem, STATGROUP_Tickables);
+}
+
+bool UGCInventoryEventSubsystem::DoesSupportWorldType(const EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UGCInventoryEventSubsystem::QueueItemEvent(UGCActorInventoryComponent* inventory, EGCInventoryItemEventType eventType, const FGameplayTag& itemTag, float itemStack)
+{
+	FGCQueuedInventoryItemEvent& itemEvent = PendingItemEvents.AddDefaulted_GetRef();
+	itemEvent.Inventory = inventory;
+	itemEvent.ItemTag = itemTag;
+	itemEvent.ItemStack = itemStack;
+	itemEvent.EventType = eventType;
+
+	++NumPendingItemEventsPerInventory.FindOrAdd(itemEvent.Inventory);
+}
+
+void UGCInventoryEventSubsystem::FlushItemEvents(UGCActorInventoryComponent* inventory)
+{
+	const TWeakObjectPtr<UGCActorInventoryComponent> inventoryKey = inventory;
+
+	// the scan stops after the last queued event of the inventory, events queued by the listeners while flushing are flushed as well
+	for (int32 eventIndex = FirstPendingItemEvent; eventIndex < PendingItemEvents.Num() && NumPendingItemEventsPerInventory.FindRef(inventoryKey) > 0; ++eventIndex)
+	{
+		if (PendingItemEvents[eventIndex].Inventory != inventoryKey)
+		{
+			continue;
+		}
+
+		// copied since the broadcast can grow the queue, the queued one is skipped by the next dispatch
+		const FGCQueuedInventoryItemEvent itemEvent = PendingItemEvents[eventIndex];
+		PendingItemEvents[eventIndex].Inventory.Reset();
+		ReleasePendingItemEvent(inventoryKey);
+
+		inventory->DispatchItemEvent(itemEvent.EventType, itemEvent.ItemTag, itemEvent.ItemStack);
+	}
+}
+
+void UGCInventoryEventSubsystem::DispatchItemEvents(double budgetSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCInventory_DispatchItemEvents);
+	CSV_SCOPED_TIMING_STAT(GCInventory, DispatchItemEvents);
+
+	const double startTime = FPlatformTime::Seconds();
+	int32 numDispatchedEvents = 0;
+
+	// listeners may queue more events while they are broadcasted, they are dispatched in order in the same pass if the budget allows it
+	while (FirstPendingItemEvent < PendingItemEvents.Num())
+	{
+		// copied since the broadcast can grow the queue
+		const FGCQueuedInventoryItemEvent itemEvent = PendingItemEvents[FirstPendingItemEvent++];
+
+		// events already broadcasted by a flush were reset, the ones of destroyed inventories are still counted
+		if (!itemEvent.Inventory.IsExplicitlyNull())
+		{
+			ReleasePendingItemEvent(itemEvent.Inventory);
+		}
+
+		if (const auto inventory = itemEvent.Inventory.Get())
+		{
+			inventory->DispatchItemEvent(itemEvent.EventType, itemEvent.ItemTag, itemEvent.ItemStack);
+		}
+
+		++numDispatchedEvents;
+
+		if (FPlatformTime::Seconds() - startTime >= budgetSeconds)
+		{
+			break;
+		}
+	}
+
+	if (FirstPendingItemEvent == PendingItemEvents.Num())
+	{
+		PendingItemEvents.Reset();
+		FirstPendingItemEvent = 0;
+	}
+	else if (FirstPendingItemEvent > PendingItemEvents.Num() / 2)
+	{
+		PendingItemEvents.RemoveAt(0, FirstPendingItemEvent, EAllowShrinking::No);
+		FirstPendingItemEvent = 0;
+	}
+
+	INC_DWORD_STAT_BY(STAT_GCInventory_DispatchedItemEvents, numDispatchedEvents);
+	CSV_CUSTOM_STAT(GCInventory, DispatchedItemEvents, numDispatchedEvents, ECsvCustomStatOp::Accumulate);
+}
+
+void UGCInventoryEventSubsystem::ReleasePendingItemEvent(const TWeakObjectPtr<UGCActorInventoryComponent>& inventory)
+{
+	if (int32* numPendingItemEvents = NumPendingItemEventsPerInventory.Find(inventory))
+	{
+		if (--(*numPendingItemEvents) <= 0)
+		{
+			NumPendingItemEventsPerInventory.Remove(inventory);
+		}
+	}
+}
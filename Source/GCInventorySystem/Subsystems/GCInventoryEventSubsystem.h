@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Types/InventoryTypes.h"
+
+#include "GCInventoryEventSubsystem.generated.h"
+
+class UGCActorInventoryComponent;
+
+// Item delegate waiting to be broadcasted by its inventory
+struct FGCQueuedInventoryItemEvent
+{
+	TWeakObjectPtr<UGCActorInventoryComponent> Inventory;
+
+	FGameplayTag ItemTag;
+
+	float ItemStack = 0.f;
+
+	EGCInventoryItemEventType EventType = EGCInventoryItemEventType::Granted;
+};
+
+/**
+ * Queue of the item delegates of the inventories that defer them (see UGCActorInventoryComponent::bDeferItemEvents).
+ * The queue is drained in order every frame within the DeferredItemEventsFrameBudgetMs of the inventory settings,
+ * so the events of an inventory are always broadcasted in the order they happened.
+ */
+UCLASS()
+class GCINVENTORYSYSTEM_API UGCInventoryEventSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UGCInventoryEventSubsystem* Get(const UObject* worldContextObject);
+
+	// Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	// End USubsystem Interface
+
+	// Begin FTickableGameObject Interface
+	virtual void Tick(float deltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject Interface
+
+	void QueueItemEvent(UGCActorInventoryComponent* inventory, EGCInventoryItemEventType eventType, const FGameplayTag& itemTag, float itemStack);
+
+	// Broadcasts every queued event of the inventory right away and in order, ignoring the frame budget. The events of the other inventories stay queued.
+	void FlushItemEvents(UGCActorInventoryComponent* inventory);
+
+	int32 GetNumPendingItemEvents() const
+	{
+		return PendingItemEvents.Num() - FirstPendingItemEvent;
+	}
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type worldType) const override;
+
+	// Broadcasts the queued events until the queue is empty or the budget is spent. Always broadcasts at least one event so the queue keeps moving.
+	void DispatchItemEvents(double budgetSeconds);
+
+	// Forgets a queued event of the inventory once it was broadcasted or skipped
+	void ReleasePendingItemEvent(const TWeakObjectPtr<UGCActorInventoryComponent>& inventory);
+
+	// Events are consumed from FirstPendingItemEvent and the consumed ones are removed in bulk
+	TArray<FGCQueuedInventoryItemEvent> PendingItemEvents;
+
+	int32 FirstPendingItemEvent = 0;
+
+	// Number of queued events of every inventory, so flushing an inventory without queued events does not scan the queue
+	TMap<TWeakObjectPtr<UGCActorInventoryComponent>, int32> NumPendingItemEventsPerInventory;
+};
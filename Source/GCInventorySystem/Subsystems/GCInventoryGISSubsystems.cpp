@@ -4,9 +4,40 @@
 #include "Modules/GCInventorySystem.h"
 #include <GameFramework/PlayerState.h>
 #include <InstancedStruct.h>
-#include <Kismet/DataTableFunctionLibrary.h>
 #include <Engine/DataTable.h>
+#include <Engine/AssetManager.h>
+#include <Engine/StreamableManager.h>
 #include <Kismet/KismetSystemLibrary.h>
+#include <Async/Async.h>
+#include <Misc/Paths.h>
+
+namespace GCInventorySubsystem
+{
+	// Items information built away from the game thread and then handed over to the subsystem
+	struct FItemsDatabaseBuildData
+	{
+		TArray<TPair<FGameplayTag, const UDataTable*>> ItemsTables;
+
+		TSet<FGameplayTag> OnDemandCategories;
+
+		TMap<FGameplayTag, FItemKeyInfo> AllItemsInventory;
+
+		TMap<FGameplayTag, FGCItemRowCacheEntry> ItemRowCache;
+
+		FGCCompiledRecipeTable CompiledRecipes;
+
+		FGCItemIdRegistry ItemIdRegistry;
+
+		FGCRecipeGraph RecipeGraph;
+	};
+
+	TSet<FGameplayTag> GetOnDemandCategories(const UGCInventoryMappingDataAsset& dataAsset)
+	{
+		TSet<FGameplayTag> onDemandCategories;
+		dataAsset.OnDemandItemsCategoryMap.GetKeys(onDemandCategories);
+		return onDemandCategories;
+	}
+}
 
 UGCInventoryGISSubsystems::UGCInventoryGISSubsystems()
 {
@@ -32,11 +63,36 @@ void UGCInventoryGISSubsystems::Initialize(FSubsystemCollectionBase& collection)
 {
 	Super::Initialize(collection);
 
-	InitializeItemsInformation();
+	if (bUseCookedItemDatabase && InitializeFromCookedItemDatabase())
+	{
+		return;
+	}
+
+	if (bInitializeItemsAsynchronously)
+	{
+		InitializeItemsInformationAsync();
+	}
+	else
+	{
+		InitializeItemsInformation();
+	}
 }
 
 void UGCInventoryGISSubsystems::Deinitialize()
 {
+	// a completed handle may still be held by the indexing task, which releases it once done
+	if (ItemsDataAssetHandle.IsValid() && ItemsDataAssetHandle->IsLoadingInProgress())
+	{
+		ItemsDataAssetHandle->CancelHandle();
+	}
+	ItemsDataAssetHandle.Reset();
+
+	ResetItemsInformation();
+	SetItemsDatabaseState(EGCItemsDatabaseState::Uninitialized);
+	OnItemsDatabaseReadyNative.Clear();
+	OnCompiledRecipesChanged.Clear();
+	OnItemIdsAdded.Clear();
+
 	Super::Deinitialize();
 }
 
@@ -59,29 +115,38 @@ DEFINE_FUNCTION(UGCInventoryGISSubsystems::execK2_GetItemStrcutFromTag)
 
 	FStructProperty* StructProp = CastField<FStructProperty>(Stack.MostRecentProperty);
 
-	const auto usedItemInfo = P_THIS->GetItemKeyInformationFromTag(itemTag);
-
-	if (const auto dataAsset = P_THIS->ItemsDataAsset.LoadSynchronous())
+	if (const auto cachedRow = P_THIS->FindItemRow(itemTag))
 	{
-		if (const auto itemCategory = dataAsset->FindItemsDataTable(usedItemInfo.ItemCategoryTag))
+		if (StructProp && itemData && cachedRow->RowStruct)
 		{
-			if (StructProp && itemData)
-			{
-				UScriptStruct* OutputType = StructProp->Struct;
-				const UScriptStruct* TableType = itemCategory->GetRowStruct();
+			UScriptStruct* OutputType = StructProp->Struct;
+			const UScriptStruct* TableType = cachedRow->RowStruct;
 
-				const bool bCompatible = (OutputType == TableType) ||
-					(OutputType->IsChildOf(TableType) && FStructUtils::TheSameLayout(OutputType, TableType));
-				if (bCompatible)
-				{
-					P_NATIVE_BEGIN;
-					bSuccess = P_THIS->Generic_GetDataTableRowFromName(itemCategory, FName(*itemTag.ToString()), itemData);
-					P_NATIVE_END;
-				}
-				*(bool*)RESULT_PARAM = bSuccess;
+			const bool bCompatible = (OutputType == TableType) ||
+				(OutputType->IsChildOf(TableType) && FStructUtils::TheSameLayout(OutputType, TableType));
+			if (bCompatible)
+			{
+				P_NATIVE_BEGIN;
+				TableType->CopyScriptStruct(itemData, cachedRow->RowData);
+				bSuccess = true;
+				P_NATIVE_END;
 			}
 		}
 	}
+
+	*(bool*)RESULT_PARAM = bSuccess;
+}
+
+void UGCInventoryGISSubsystems::CallOrRegister_OnItemsDatabaseReady(FSimpleMulticastDelegate::FDelegate&& delegate)
+{
+	if (IsItemsDatabaseReady())
+	{
+		delegate.ExecuteIfBound();
+	}
+	else
+	{
+		OnItemsDatabaseReadyNative.Add(MoveTemp(delegate));
+	}
 }
 
 FItemRecipeElements UGCInventoryGISSubsystems::GetItemRecipe(const FGameplayTag& itemTag)
@@ -90,9 +155,15 @@ FItemRecipeElements UGCInventoryGISSubsystems::GetItemRecipe(const FGameplayTag&
 	{
 		const auto usedItemInfo = GetItemKeyInformationFromTag(itemTag);
 
-		const auto itemCategory = dataAsset->FindRecipesCategory(usedItemInfo.ItemCategoryTag);
+		if (const auto itemCategory = dataAsset->ItemsCategoryCraftingRecipes.Find(usedItemInfo.ItemCategoryTag))
+		{
+			if (const auto itemRecipe = itemCategory->ItemRecipes.Find(itemTag))
+			{
+				return *itemRecipe;
+			}
+		}
 
-		return itemCategory.ItemRecipes[itemTag];
+		UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Could not find a recipe for the item: %s"), ANSI_TO_TCHAR(__FUNCTION__), *itemTag.ToString());
 	}
 	else
 	{
@@ -102,11 +173,27 @@ FItemRecipeElements UGCInventoryGISSubsystems::GetItemRecipe(const FGameplayTag&
 	return FItemRecipeElements();
 }
 
-FItemKeyInfo UGCInventoryGISSubsystems::GetItemKeyInformationFromTag(const FGameplayTag& itemTag) const
+FItemKeyInfo UGCInventoryGISSubsystems::GetItemKeyInformationFromTag(const FGameplayTag& itemTag)
 {
-	if (AllItemsInventory.Contains(itemTag))
+	if (const auto itemInfo = AllItemsInventory.Find(itemTag))
 	{
-		return AllItemsInventory[itemTag];
+		return *itemInfo;
+	}
+
+	if (const auto cookedItem = CookedItemDatabase.FindItem(itemTag))
+	{
+		FItemKeyInfo cookedItemInfo;
+		cookedItemInfo.ItemTag = itemTag;
+		cookedItemInfo.ItemCategoryTag = FGCCookedItemDatabase::GetTagFromNetIndex(cookedItem->CategoryNetIndex);
+		return cookedItemInfo;
+	}
+
+	if (LoadOnDemandItemsCategory(itemTag))
+	{
+		if (const auto itemInfo = AllItemsInventory.Find(itemTag))
+		{
+			return *itemInfo;
+		}
 	}
 
 	UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Could not find the item with the tag: %s"), ANSI_TO_TCHAR(__FUNCTION__), *itemTag.ToString());
@@ -116,37 +203,21 @@ FItemKeyInfo UGCInventoryGISSubsystems::GetItemKeyInformationFromTag(const FGame
 
 void UGCInventoryGISSubsystems::InitializeItemsInformation()
 {
+	SetItemsDatabaseState(EGCItemsDatabaseState::Loading);
+
 	if (ensureMsgf(UKismetSystemLibrary::IsValidSoftObjectReference(ItemsDataAsset), TEXT("Items data asset is not valid, without this file the system won't work. Please Fix it")))
 	{
 		if (const auto dataAsset = ItemsDataAsset.LoadSynchronous())
 		{
-			TArray<FGameplayTag> itemCategories;
-			dataAsset->ItemsCategoryMap.GetKeys(itemCategories);
+			LoadedItemsDataAsset = dataAsset;
 
-			if (itemCategories.Num() > 0)
+			if (dataAsset->ItemsCategoryMap.Num() > 0)
 			{
-				for (const auto& categoryTag : itemCategories)
+				for (const auto& itemCategory : dataAsset->ItemsCategoryMap)
 				{
-					if (const auto itemCategory = dataAsset->FindItemsDataTable(categoryTag))
+					if (itemCategory.Value)
 					{
-						TArray<FName> tableRowNames;
-						UDataTableFunctionLibrary::GetDataTableRowNames(itemCategory, tableRowNames);
-
-						if (tableRowNames.Num() > 0)
-						{
-							for (const auto& itemNameTag : tableRowNames)
-							{
-								const auto itemTag = FGameplayTag::RequestGameplayTag(itemNameTag);
-								FItemKeyInfo newItemInfo;
-								newItemInfo.ItemTag = itemTag;
-								newItemInfo.ItemCategoryTag = categoryTag;
-								AllItemsInventory.Add(itemTag, newItemInfo);
-							}
-						}
-						else
-						{
-							UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Item Category info is empty. Please fill it with information."), ANSI_TO_TCHAR(__FUNCTION__));
-						}
+						CacheItemsDataTable(itemCategory.Key, itemCategory.Value, AllItemsInventory, ItemRowCache);
 					}
 					else
 					{
@@ -158,6 +229,15 @@ void UGCInventoryGISSubsystems::InitializeItemsInformation()
 			{
 				UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Item Data Asset is empty. Please fill it with information."), ANSI_TO_TCHAR(__FUNCTION__));
 			}
+
+			CompiledRecipes.Build(dataAsset->ItemsCategoryCraftingRecipes, AllItemsInventory, GCInventorySubsystem::GetOnDemandCategories(*dataAsset));
+			BuildItemIds(AllItemsInventory, CompiledRecipes, ItemIdRegistry);
+			RecipeGraph.Build(CompiledRecipes);
+
+			BindItemsDataTablesChanged();
+
+			SetItemsDatabaseState(EGCItemsDatabaseState::Ready);
+			return;
 		}
 		else
 		{
@@ -168,6 +248,578 @@ void UGCInventoryGISSubsystems::InitializeItemsInformation()
 	{
 		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Item Data asset reference is not valid"), ANSI_TO_TCHAR(__FUNCTION__));
 	}
+
+	SetItemsDatabaseState(EGCItemsDatabaseState::Failed);
+}
+
+void UGCInventoryGISSubsystems::InitializeItemsInformationAsync()
+{
+	if (!UKismetSystemLibrary::IsValidSoftObjectReference(ItemsDataAsset))
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Item Data asset reference is not valid"), ANSI_TO_TCHAR(__FUNCTION__));
+		SetItemsDatabaseState(EGCItemsDatabaseState::Failed);
+		return;
+	}
+
+	SetItemsDatabaseState(EGCItemsDatabaseState::Loading);
+
+	// the category tables are hard referenced by the data asset, so they are streamed along with it
+	ItemsDataAssetHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(ItemsDataAsset.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &ThisClass::HandleItemsDataAssetLoaded));
+
+	if (!ItemsDataAssetHandle.IsValid())
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to request the ItemsDataAsset load."), ANSI_TO_TCHAR(__FUNCTION__));
+		SetItemsDatabaseState(EGCItemsDatabaseState::Failed);
+	}
+}
+
+void UGCInventoryGISSubsystems::HandleItemsDataAssetLoaded()
+{
+	const auto dataAsset = ItemsDataAsset.Get();
+
+	if (!dataAsset)
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to find ItemsDataAsset. Cannot fill the item information."), ANSI_TO_TCHAR(__FUNCTION__));
+		SetItemsDatabaseState(EGCItemsDatabaseState::Failed);
+		return;
+	}
+
+	LoadedItemsDataAsset = dataAsset;
+
+	const auto buildData = MakeShared<GCInventorySubsystem::FItemsDatabaseBuildData, ESPMode::ThreadSafe>();
+	buildData->OnDemandCategories = GCInventorySubsystem::GetOnDemandCategories(*dataAsset);
+	buildData->ItemsTables.Reserve(dataAsset->ItemsCategoryMap.Num());
+
+	for (const auto& itemCategory : dataAsset->ItemsCategoryMap)
+	{
+		if (itemCategory.Value)
+		{
+			buildData->ItemsTables.Emplace(itemCategory.Key, itemCategory.Value);
+		}
+		else
+		{
+			UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to find the desired item category"), ANSI_TO_TCHAR(__FUNCTION__));
+		}
+	}
+
+	// the worker only reads the loaded tables, which the streamable handle keeps referenced until the build is done
+	Async(EAsyncExecution::ThreadPool, [buildData, dataAsset, assetHandle = ItemsDataAssetHandle, weakThis = TWeakObjectPtr<ThisClass>(this)]()
+		{
+			for (const auto& itemsTable : buildData->ItemsTables)
+			{
+				CacheItemsDataTable(itemsTable.Key, itemsTable.Value, buildData->AllItemsInventory, buildData->ItemRowCache);
+			}
+
+			buildData->CompiledRecipes.Build(dataAsset->ItemsCategoryCraftingRecipes, buildData->AllItemsInventory, buildData->OnDemandCategories);
+			BuildItemIds(buildData->AllItemsInventory, buildData->CompiledRecipes, buildData->ItemIdRegistry);
+			buildData->RecipeGraph.Build(buildData->CompiledRecipes);
+
+			AsyncTask(ENamedThreads::GameThread, [buildData, assetHandle, weakThis]()
+				{
+					const auto inventorySubsystem = weakThis.Get();
+
+					if (!inventorySubsystem || inventorySubsystem->ItemsDatabaseState != EGCItemsDatabaseState::Loading)
+					{
+						return;
+					}
+
+					inventorySubsystem->AllItemsInventory = MoveTemp(buildData->AllItemsInventory);
+					inventorySubsystem->ItemRowCache = MoveTemp(buildData->ItemRowCache);
+					inventorySubsystem->CompiledRecipes = MoveTemp(buildData->CompiledRecipes);
+					inventorySubsystem->ItemIdRegistry = MoveTemp(buildData->ItemIdRegistry);
+					inventorySubsystem->RecipeGraph = MoveTemp(buildData->RecipeGraph);
+
+					inventorySubsystem->BindItemsDataTablesChanged();
+
+					inventorySubsystem->SetItemsDatabaseState(EGCItemsDatabaseState::Ready);
+				});
+		});
+}
+
+bool UGCInventoryGISSubsystems::InitializeFromCookedItemDatabase()
+{
+	if (!CookedItemDatabase.Open(GetCookedItemDatabaseFilename()))
+	{
+		UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Cooked item database not available, the items information will be built from the data asset."), ANSI_TO_TCHAR(__FUNCTION__));
+		return false;
+	}
+
+	// the data asset hard references every items table, so it is only loaded once a row is resolved
+	if (!UKismetSystemLibrary::IsValidSoftObjectReference(ItemsDataAsset))
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to find ItemsDataAsset. Cannot fill the item information."), ANSI_TO_TCHAR(__FUNCTION__));
+		CookedItemDatabase.Close();
+		return false;
+	}
+
+	SetItemsDatabaseState(EGCItemsDatabaseState::Loading);
+
+	// items are resolved lazily from the mapped file, only the recipes are turned into tags up front
+	const auto cookedHeader = CookedItemDatabase.GetHeader();
+	const auto cookedItems = CookedItemDatabase.GetItems();
+
+	TArray<FGameplayTag> itemTags;
+	itemTags.Reserve(cookedItems.Num());
+
+	for (const auto& cookedItem : cookedItems)
+	{
+		itemTags.Add(FGCCookedItemDatabase::GetTagFromNetIndex(cookedItem.ItemNetIndex));
+	}
+
+	// the file is sorted by net index, which is as stable as the tag dictionary the file was checked against, so the ids keep its order
+	ItemIdRegistry.BuildInOrder(itemTags);
+
+	CompiledRecipes.Reset();
+	CompiledRecipes.Reserve(cookedHeader->NumRecipes, cookedHeader->NumIngredients);
+
+	TArray<FGCRecipeIngredient, TInlineAllocator<16>> ingredients;
+
+	for (int32 itemIndex = 0; itemIndex < cookedItems.Num(); ++itemIndex)
+	{
+		const auto& cookedItem = cookedItems[itemIndex];
+
+		if (cookedItem.FirstIngredient == INDEX_NONE)
+		{
+			continue;
+		}
+
+		ingredients.Reset();
+
+		for (const auto& cookedIngredient : CookedItemDatabase.GetIngredients(cookedItem))
+		{
+			ingredients.Add({ FGCCookedItemDatabase::GetTagFromNetIndex(cookedIngredient.ItemNetIndex), cookedIngredient.Amount });
+		}
+
+		CompiledRecipes.AddRecipe(itemTags[itemIndex], cookedItem.CraftedQuantity, ingredients, cookedItem.CraftingTime);
+	}
+
+	CompiledRecipes.AssignItemIds(ItemIdRegistry);
+	RecipeGraph.Build(CompiledRecipes);
+
+	// the recipes come from the cooked file, so the tables are not watched for changes
+
+	SetItemsDatabaseState(EGCItemsDatabaseState::Ready);
+
+	return true;
+}
+
+UGCInventoryMappingDataAsset* UGCInventoryGISSubsystems::ResolveItemsDataAsset()
+{
+	if (!LoadedItemsDataAsset && CookedItemDatabase.IsOpen())
+	{
+		LoadedItemsDataAsset = ItemsDataAsset.LoadSynchronous();
+
+		if (!LoadedItemsDataAsset)
+		{
+			UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to find ItemsDataAsset. Cannot resolve the item rows."), ANSI_TO_TCHAR(__FUNCTION__));
+		}
+	}
+
+	return LoadedItemsDataAsset;
+}
+
+bool UGCInventoryGISSubsystems::CacheCookedItemRow(const FGameplayTag& itemTag)
+{
+	const auto cookedItem = CookedItemDatabase.FindItem(itemTag);
+
+	if (!cookedItem || !ResolveItemsDataAsset())
+	{
+		return false;
+	}
+
+	// on demand categories are cached as a whole when they get loaded
+	const auto categoryTag = FGCCookedItemDatabase::GetTagFromNetIndex(cookedItem->CategoryNetIndex);
+	const auto itemsTable = LoadedItemsDataAsset->ItemsCategoryMap.FindRef(categoryTag);
+
+	if (!itemsTable)
+	{
+		return false;
+	}
+
+	// the row name is the tag name, no need to go through the tag string
+	const auto rowData = itemsTable->FindRowUnchecked(itemTag.GetTagName());
+
+	if (!rowData)
+	{
+		return false;
+	}
+
+	FGCItemRowCacheEntry& cachedRow = ItemRowCache.Add(itemTag);
+	cachedRow.RowStruct = itemsTable->GetRowStruct();
+	cachedRow.RowData = rowData;
+	cachedRow.ItemCategoryTag = categoryTag;
+
+	return true;
+}
+
+FString UGCInventoryGISSubsystems::GetCookedItemDatabaseFilename() const
+{
+	return FPaths::Combine(FPaths::ProjectDir(), CookedItemDatabasePath);
+}
+
+void UGCInventoryGISSubsystems::BindItemsDataTablesChanged()
+{
+	if (!LoadedItemsDataAsset)
+	{
+		return;
+	}
+
+	for (const auto& itemCategory : LoadedItemsDataAsset->ItemsCategoryMap)
+	{
+		if (itemCategory.Value && !ItemsTableChangedHandles.Contains(itemCategory.Value))
+		{
+			const auto changedHandle = itemCategory.Value->OnDataTableChanged().AddUObject(this, &ThisClass::HandleItemsDataTableChanged, itemCategory.Key);
+			ItemsTableChangedHandles.Add(itemCategory.Value, changedHandle);
+		}
+	}
+}
+
+void UGCInventoryGISSubsystems::SetItemsDatabaseState(EGCItemsDatabaseState newState)
+{
+	if (ItemsDatabaseState == newState)
+	{
+		return;
+	}
+
+	ItemsDatabaseState = newState;
+
+	if (ItemsDatabaseState == EGCItemsDatabaseState::Ready)
+	{
+		OnItemsDatabaseReadyNative.Broadcast();
+		OnItemsDatabaseReadyNative.Clear();
+
+		OnItemsDatabaseReady.Broadcast();
+	}
+}
+
+void UGCInventoryGISSubsystems::CacheItemsDataTable(const FGameplayTag& categoryTag, const UDataTable* itemsTable, TMap<FGameplayTag, FItemKeyInfo>& outItemsInformation, TMap<FGameplayTag, FGCItemRowCacheEntry>& outItemRowCache, bool bOnDemandCategory /*= false*/)
+{
+	const auto& tableRows = itemsTable->GetRowMap();
+
+	if (tableRows.Num() > 0)
+	{
+		const UScriptStruct* rowStruct = itemsTable->GetRowStruct();
+
+		outItemsInformation.Reserve(outItemsInformation.Num() + tableRows.Num());
+		outItemRowCache.Reserve(outItemRowCache.Num() + tableRows.Num());
+
+		for (const auto& tableRow : tableRows)
+		{
+			const auto itemTag = FGameplayTag::RequestGameplayTag(tableRow.Key);
+			FItemKeyInfo newItemInfo;
+			newItemInfo.ItemTag = itemTag;
+			newItemInfo.ItemCategoryTag = categoryTag;
+			outItemsInformation.Add(itemTag, newItemInfo);
+
+			FGCItemRowCacheEntry& cachedRow = outItemRowCache.Add(itemTag);
+			cachedRow.RowStruct = rowStruct;
+			cachedRow.RowData = tableRow.Value;
+			cachedRow.ItemCategoryTag = categoryTag;
+			cachedRow.bOnDemandCategory = bOnDemandCategory;
+		}
+	}
+	else
+	{
+		UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Item Category info is empty. Please fill it with information."), ANSI_TO_TCHAR(__FUNCTION__));
+	}
+}
+
+void UGCInventoryGISSubsystems::BuildItemIds(const TMap<FGameplayTag, FItemKeyInfo>& itemsInformation, FGCCompiledRecipeTable& compiledRecipes, FGCItemIdRegistry& outItemIdRegistry)
+{
+	TArray<FGameplayTag> itemTags;
+	itemsInformation.GetKeys(itemTags);
+
+	outItemIdRegistry.Build(MoveTemp(itemTags));
+	compiledRecipes.AssignItemIds(outItemIdRegistry);
+}
+
+void UGCInventoryGISSubsystems::UncacheItemsCategory(const FGameplayTag& categoryTag)
+{
+	for (auto It = ItemRowCache.CreateIterator(); It; ++It)
+	{
+		if (It->Value.ItemCategoryTag == categoryTag)
+		{
+			AllItemsInventory.Remove(It->Key);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UGCInventoryGISSubsystems::HandleItemsDataTableChanged(FGameplayTag categoryTag)
+{
+	// rows may have been reallocated, so every pointer of the category is stale
+	UncacheItemsCategory(categoryTag);
+
+	if (LoadedItemsDataAsset)
+	{
+		if (const auto onDemandTable = ResidentOnDemandTables.FindRef(categoryTag))
+		{
+			CacheItemsDataTable(categoryTag, onDemandTable, AllItemsInventory, ItemRowCache, true);
+		}
+		else if (const auto itemsTable = LoadedItemsDataAsset->FindItemsDataTable(categoryTag))
+		{
+			CacheItemsDataTable(categoryTag, itemsTable, AllItemsInventory, ItemRowCache);
+		}
+
+		CompiledRecipes.Build(LoadedItemsDataAsset->ItemsCategoryCraftingRecipes, AllItemsInventory, GCInventorySubsystem::GetOnDemandCategories(*LoadedItemsDataAsset));
+
+		// inventories keep using the ids they were given, so new items are only appended
+		const int32 numItemIds = ItemIdRegistry.Num();
+		for (const auto& itemInfo : AllItemsInventory)
+		{
+			ItemIdRegistry.AddItem(itemInfo.Key);
+		}
+		CompiledRecipes.AssignItemIds(ItemIdRegistry);
+		RecipeGraph.Build(CompiledRecipes);
+
+		OnCompiledRecipesChanged.Broadcast();
+
+		if (ItemIdRegistry.Num() != numItemIds)
+		{
+			OnItemIdsAdded.Broadcast();
+		}
+	}
+}
+
+const FGCItemRowCacheEntry* UGCInventoryGISSubsystems::FindItemRow(const FGameplayTag& itemTag)
+{
+	if (const auto cachedRow = ItemRowCache.Find(itemTag))
+	{
+		if (cachedRow->bOnDemandCategory)
+		{
+			if (const auto residency = OnDemandCategoriesResidency.Find(cachedRow->ItemCategoryTag))
+			{
+				residency->LastUsedFrame = GFrameCounter;
+			}
+		}
+
+		return cachedRow;
+	}
+
+	if (CacheCookedItemRow(itemTag) || LoadOnDemandItemsCategory(itemTag))
+	{
+		return ItemRowCache.Find(itemTag);
+	}
+
+	return nullptr;
+}
+
+FGameplayTag UGCInventoryGISSubsystems::FindOnDemandItemsCategory(const FGameplayTag& itemTag) const
+{
+	if (LoadedItemsDataAsset && LoadedItemsDataAsset->OnDemandItemsCategoryMap.Num() > 0)
+	{
+		// on demand items are identified by being children of their category tag
+		for (FGameplayTag categoryTag = itemTag; categoryTag.IsValid(); categoryTag = categoryTag.RequestDirectParent())
+		{
+			if (LoadedItemsDataAsset->OnDemandItemsCategoryMap.Contains(categoryTag))
+			{
+				return categoryTag;
+			}
+		}
+	}
+
+	return FGameplayTag();
+}
+
+bool UGCInventoryGISSubsystems::LoadOnDemandItemsCategory(const FGameplayTag& itemTag)
+{
+	// the items built by the asynchronous initialization replace the cached ones when they are handed over, a category cached before would be lost
+	if (ItemsDatabaseState == EGCItemsDatabaseState::Loading)
+	{
+		return false;
+	}
+
+	ResolveItemsDataAsset();
+
+	const FGameplayTag categoryTag = FindOnDemandItemsCategory(itemTag);
+
+	if (!categoryTag.IsValid() || ResidentOnDemandTables.Contains(categoryTag))
+	{
+		return false;
+	}
+
+	const auto itemsTable = LoadedItemsDataAsset->OnDemandItemsCategoryMap.FindChecked(categoryTag).LoadSynchronous();
+
+	if (!itemsTable)
+	{
+		UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to load the items table of the on demand category: %s"), ANSI_TO_TCHAR(__FUNCTION__), *categoryTag.ToString());
+		return false;
+	}
+
+	RegisterOnDemandItemsCategory(categoryTag, itemsTable);
+
+	return true;
+}
+
+void UGCInventoryGISSubsystems::RequestItemsCategoryLoad(const FGameplayTag& itemTag, FSimpleDelegate onLoaded /*= FSimpleDelegate()*/)
+{
+	// same as LoadOnDemandItemsCategory, the category is only requested once the items database is ready
+	if (ItemsDatabaseState == EGCItemsDatabaseState::Loading)
+	{
+		CallOrRegister_OnItemsDatabaseReady(FSimpleDelegate::CreateWeakLambda(this, [this, itemTag, onLoaded]()
+			{
+				RequestItemsCategoryLoad(itemTag, onLoaded);
+			}));
+		return;
+	}
+
+	ResolveItemsDataAsset();
+
+	const FGameplayTag categoryTag = FindOnDemandItemsCategory(itemTag);
+
+	if (!categoryTag.IsValid() || ResidentOnDemandTables.Contains(categoryTag))
+	{
+		onLoaded.ExecuteIfBound();
+		return;
+	}
+
+	const auto softItemsTable = LoadedItemsDataAsset->OnDemandItemsCategoryMap.FindChecked(categoryTag);
+
+	UAssetManager::GetStreamableManager().RequestAsyncLoad(softItemsTable.ToSoftObjectPath(), FStreamableDelegate::CreateWeakLambda(this, [this, categoryTag, softItemsTable, onLoaded]()
+		{
+			// a synchronous query may have loaded the category in the meantime, or the items may have been reset
+			if (LoadedItemsDataAsset && !ResidentOnDemandTables.Contains(categoryTag))
+			{
+				if (const auto itemsTable = softItemsTable.Get())
+				{
+					RegisterOnDemandItemsCategory(categoryTag, itemsTable);
+				}
+				else
+				{
+					UE_LOG(LogInventorySystem, Error, TEXT("[%s] Failed to load the items table of the on demand category: %s"), ANSI_TO_TCHAR(__FUNCTION__), *categoryTag.ToString());
+				}
+			}
+
+			onLoaded.ExecuteIfBound();
+		}));
+}
+
+void UGCInventoryGISSubsystems::RegisterOnDemandItemsCategory(const FGameplayTag& categoryTag, UDataTable* itemsTable)
+{
+	CacheItemsDataTable(categoryTag, itemsTable, AllItemsInventory, ItemRowCache, true);
+
+	const int32 numItemIds = ItemIdRegistry.Num();
+	for (const auto& tableRow : itemsTable->GetRowMap())
+	{
+		ItemIdRegistry.AddItem(FGameplayTag::RequestGameplayTag(tableRow.Key));
+	}
+
+	FGCOnDemandCategoryResidency& residency = OnDemandCategoriesResidency.Add(categoryTag);
+	residency.ResidentBytes = itemsTable->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	residency.LastUsedFrame = GFrameCounter;
+
+	OnDemandCategoriesResidentBytes += residency.ResidentBytes;
+	ResidentOnDemandTables.Add(categoryTag, itemsTable);
+
+	// rebuilding the recipes from the cached items would drop the ones of the cooked file
+	if (!CookedItemDatabase.IsOpen())
+	{
+		const auto changedHandle = itemsTable->OnDataTableChanged().AddUObject(this, &ThisClass::HandleItemsDataTableChanged, categoryTag);
+		ItemsTableChangedHandles.Add(itemsTable, changedHandle);
+	}
+
+	UE_LOG(LogInventorySystem, Verbose, TEXT("[%s] Loaded on demand category %s (%lld bytes)"), ANSI_TO_TCHAR(__FUNCTION__), *categoryTag.ToString(), residency.ResidentBytes);
+
+	EnforceOnDemandCategoriesBudget(categoryTag);
+
+	if (ItemIdRegistry.Num() != numItemIds)
+	{
+		OnItemIdsAdded.Broadcast();
+	}
+}
+
+void UGCInventoryGISSubsystems::UnloadOnDemandItemsCategory(const FGameplayTag& categoryTag)
+{
+	TObjectPtr<UDataTable> itemsTable = nullptr;
+
+	if (!ResidentOnDemandTables.RemoveAndCopyValue(categoryTag, itemsTable))
+	{
+		return;
+	}
+
+	UncacheItemsCategory(categoryTag);
+
+	FDelegateHandle changedHandle;
+	if (itemsTable && ItemsTableChangedHandles.RemoveAndCopyValue(itemsTable.Get(), changedHandle))
+	{
+		itemsTable->OnDataTableChanged().Remove(changedHandle);
+	}
+
+	FGCOnDemandCategoryResidency residency;
+	if (OnDemandCategoriesResidency.RemoveAndCopyValue(categoryTag, residency))
+	{
+		OnDemandCategoriesResidentBytes -= residency.ResidentBytes;
+	}
+
+	UE_LOG(LogInventorySystem, Verbose, TEXT("[%s] Evicted on demand category %s (%lld bytes)"), ANSI_TO_TCHAR(__FUNCTION__), *categoryTag.ToString(), residency.ResidentBytes);
+}
+
+void UGCInventoryGISSubsystems::EnforceOnDemandCategoriesBudget(const FGameplayTag& keptCategoryTag)
+{
+	if (OnDemandCategoriesMemoryBudget <= 0)
+	{
+		return;
+	}
+
+	while (OnDemandCategoriesResidentBytes > OnDemandCategoriesMemoryBudget)
+	{
+		// rows handed out during this frame must stay valid, so only categories unused this frame can be evicted
+		FGameplayTag coldestCategoryTag;
+		uint64 coldestFrame = GFrameCounter;
+
+		for (const auto& residency : OnDemandCategoriesResidency)
+		{
+			if (residency.Key != keptCategoryTag && residency.Value.LastUsedFrame < coldestFrame)
+			{
+				coldestCategoryTag = residency.Key;
+				coldestFrame = residency.Value.LastUsedFrame;
+			}
+		}
+
+		if (!coldestCategoryTag.IsValid())
+		{
+			UE_LOG(LogInventorySystem, Warning, TEXT("[%s] On demand categories use %lld bytes, over the budget of %lld bytes, but none of them can be evicted."), ANSI_TO_TCHAR(__FUNCTION__), OnDemandCategoriesResidentBytes, OnDemandCategoriesMemoryBudget);
+			return;
+		}
+
+		UnloadOnDemandItemsCategory(coldestCategoryTag);
+	}
+}
+
+TMap<FGameplayTag, int64> UGCInventoryGISSubsystems::GetOnDemandCategoriesResidentBytes() const
+{
+	TMap<FGameplayTag, int64> residentBytes;
+	residentBytes.Reserve(OnDemandCategoriesResidency.Num());
+
+	for (const auto& residency : OnDemandCategoriesResidency)
+	{
+		residentBytes.Add(residency.Key, residency.Value.ResidentBytes);
+	}
+
+	return residentBytes;
+}
+
+void UGCInventoryGISSubsystems::ResetItemsInformation()
+{
+	for (const auto& changedHandle : ItemsTableChangedHandles)
+	{
+		if (const auto itemsTable = changedHandle.Key.Get())
+		{
+			itemsTable->OnDataTableChanged().Remove(changedHandle.Value);
+		}
+	}
+
+	ItemsTableChangedHandles.Reset();
+	ResidentOnDemandTables.Reset();
+	OnDemandCategoriesResidency.Reset();
+	OnDemandCategoriesResidentBytes = 0;
+	ItemRowCache.Reset();
+	AllItemsInventory.Reset();
+	CompiledRecipes.Reset();
+	RecipeGraph.Reset();
+	CookedItemDatabase.Close();
+	LoadedItemsDataAsset = nullptr;
 }
 
 bool UGCInventoryGISSubsystems::Generic_GetDataTableRowFromName(const UDataTable* Table, FName RowName, void* OutRowPtr)
@@ -4,11 +4,38 @@
 
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Engine/GCInventoryMappingDataAsset.h"
+#include "Engine/GCCookedItemDatabase.h"
 #include "Types/InventoryTypes.h"
+#include "System/GCRecipeGraph.h"
 
 #include "GCInventoryGISSubsystems.generated.h"
 
 class APlayerState;
+class UDataTable;
+struct FStreamableHandle;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnItemsDatabaseReady);
+
+// Row of an item resolved once from its category data table
+struct FGCItemRowCacheEntry
+{
+	const UScriptStruct* RowStruct = nullptr;
+
+	const uint8* RowData = nullptr;
+
+	FGameplayTag ItemCategoryTag;
+
+	// Rows of on demand categories stay valid until their category is evicted
+	bool bOnDemandCategory = false;
+};
+
+// Residency information of a loaded on demand category
+struct FGCOnDemandCategoryResidency
+{
+	int64 ResidentBytes = 0;
+
+	uint64 LastUsedFrame = 0;
+};
 
 /**
  *
@@ -18,6 +45,9 @@ class GCINVENTORYSYSTEM_API UGCInventoryGISSubsystems : public UGameInstanceSubs
 {
 	GENERATED_BODY()
 
+	// The automation tests initialize the subsystem from generated items, see the GCInventorySystemTests module
+	friend class FGCInventoryTestWorld;
+
 public:
 
 	UGCInventoryGISSubsystems();
@@ -28,25 +58,47 @@ public:
 	virtual void Initialize(FSubsystemCollectionBase& collection) override;
 	virtual void Deinitialize() override;
 
-	/** Function to find the row of a table given its name. */
+	/**
+	 * Function to find the row of an item given its tag. Returns nullptr if the item does not exist or its row is not a T.
+	 * An item of an on demand category that is not resident loads the category synchronously, use RequestItemsCategoryLoad beforehand to avoid the hitch.
+	 * Rows of on demand categories are only guaranteed to stay valid during the frame they were returned in, since loading another category
+	 * can evict the categories not used this frame. Query the row again instead of keeping the pointer.
+	 */
 	template <class T>
-	T* GetItemFromTag(const FGameplayTag& itemTag) const
+	const T* GetItemFromTag(const FGameplayTag& itemTag)
 	{
-		const auto usedItemInfo = GetItemKeyInformationFromTag(itemTag);
-
-		if (const auto dataAsset = ItemsDataAsset.LoadSynchronous())
+		if (const auto cachedRow = FindItemRow(itemTag))
 		{
-			if (const auto itemCategory = dataAsset->FindItemsDataTable(usedItemInfo.ItemCategoryTag))
+			if (cachedRow->RowStruct && cachedRow->RowStruct->IsChildOf(T::StaticStruct()))
 			{
-				return itemCategory->FindRow<T>(FName(*itemTag.ToString()), "");
+				return reinterpret_cast<const T*>(cachedRow->RowData);
 			}
 		}
 
 		return nullptr;
 	}
 
+	UFUNCTION(BlueprintPure, Category = InventorySubsystem)
+	EGCItemsDatabaseState GetItemsDatabaseState() const { return ItemsDatabaseState; }
+
+	// Returns true once the items information can be queried. Always true after Initialize when loading synchronously.
+	UFUNCTION(BlueprintPure, Category = InventorySubsystem)
+	bool IsItemsDatabaseReady() const { return ItemsDatabaseState == EGCItemsDatabaseState::Ready; }
+
+	// Executes the delegate right away if the items database is ready, otherwise once it finishes loading
+	void CallOrRegister_OnItemsDatabaseReady(FSimpleMulticastDelegate::FDelegate&& delegate);
+
+	float GetDeferredItemEventsFrameBudgetMs() const { return DeferredItemEventsFrameBudgetMs; }
+
+	float GetCraftingSchedulerTickInterval() const { return CraftingSchedulerTickInterval; }
+
+	// Loads the on demand category of the item synchronously if it is not resident yet, see RequestItemsCategoryLoad
 	UFUNCTION(BlueprintCallable, Category = InventorySubsystem, meta = (AutoCreateRefTerm = "itemTag"))
-	FItemKeyInfo GetItemKeyInformationFromTag(const FGameplayTag& itemTag) const;
+	FItemKeyInfo GetItemKeyInformationFromTag(const FGameplayTag& itemTag);
+
+	// Streams the on demand category of the item in the background. The delegate is executed once its items can be queried without loading,
+	// right away if the category is resident or the item is not in an on demand category. While the items database loads the request waits for it to be ready.
+	void RequestItemsCategoryLoad(const FGameplayTag& itemTag, FSimpleDelegate onLoaded = FSimpleDelegate());
 
 	UFUNCTION(BlueprintCallable, CustomThunk, Category = "InventorySubsystem", meta = (CustomStructureParam = "itemData", AutoCreateRefTerm = "itemTag", DisplayName = "Get Item Struct From Tag"))
 	bool K2_GetItemStrcutFromTag(const FGameplayTag& itemTag, FTableRowBase& itemData);
@@ -56,19 +108,179 @@ public:
 	UFUNCTION(BlueprintCallable, Category = InventorySubsystem, meta = (AutoCreateRefTerm = "itemTag"))
 	FItemRecipeElements GetItemRecipe(const FGameplayTag& itemTag);
 
+	// Returns the recipe compiled at initialization for the item, or nullptr if the item cannot be crafted
+	const FGCCompiledRecipe* FindCompiledRecipe(const FGameplayTag& itemTag) const
+	{
+		return CompiledRecipes.FindRecipe(itemTag);
+	}
+
+	TConstArrayView<FGCRecipeIngredient> GetRecipeIngredients(const FGCCompiledRecipe& recipe) const
+	{
+		return CompiledRecipes.GetIngredients(recipe);
+	}
+
+	const FGCCompiledRecipeTable& GetCompiledRecipes() const
+	{
+		return CompiledRecipes;
+	}
+
+	// Dependencies between the compiled recipes, used to plan crafts through intermediate ingredients
+	const FGCRecipeGraph& GetRecipeGraph() const
+	{
+		return RecipeGraph;
+	}
+
+	// Broadcasted when the recipes are compiled again (an items table changed in the editor), recipe indices handed out before are stale
+	FSimpleMulticastDelegate OnCompiledRecipesChanged;
+
+	// Broadcasted when items got a dense id after initialization (an on demand category was loaded or an items table changed in the editor)
+	FSimpleMulticastDelegate OnItemIdsAdded;
+
+	// Dense ids of every known item, shared by the inventories using dense item storage. Ids are only given by the subsystem and never reused while it lives.
+	const FGCItemIdRegistry& GetItemIdRegistry() const { return ItemIdRegistry; }
+
+	// Returns the dense id of the item (or INDEX_NONE if the item is unknown)
+	int32 FindItemId(const FGameplayTag& itemTag) const { return ItemIdRegistry.FindId(itemTag); }
+
+	// Bytes kept resident by every loaded on demand category
+	UFUNCTION(BlueprintCallable, Category = InventorySubsystem)
+	TMap<FGameplayTag, int64> GetOnDemandCategoriesResidentBytes() const;
+
+	UFUNCTION(BlueprintPure, Category = InventorySubsystem)
+	int64 GetOnDemandCategoriesTotalResidentBytes() const { return OnDemandCategoriesResidentBytes; }
+
+	const TSoftObjectPtr<UGCInventoryMappingDataAsset>& GetItemsDataAsset() const { return ItemsDataAsset; }
+
+	// Absolute path of the database baked by the GCCookItemDatabase commandlet
+	FString GetCookedItemDatabaseFilename() const;
+
+	// Broadcasted once the items database finished loading
+	UPROPERTY(BlueprintAssignable, Category = InventorySubsystem)
+	FOnItemsDatabaseReady OnItemsDatabaseReady;
+
 protected:
 
 	// Function in charge of filling the information for the AllItemsInventory map
 	void InitializeItemsInformation();
 
+	// Streams the items data asset and its tables, then builds the items information on a worker thread
+	void InitializeItemsInformationAsync();
+
+	void HandleItemsDataAssetLoaded();
+
+	// Memory maps the cooked item database and compiles its recipes. Returns false if the database cannot be used.
+	bool InitializeFromCookedItemDatabase();
+
+	// Returns the items data asset, loading it the first time a row of the cooked database is resolved
+	UGCInventoryMappingDataAsset* ResolveItemsDataAsset();
+
+	// Resolves and caches the row of an item known by the cooked item database
+	bool CacheCookedItemRow(const FGameplayTag& itemTag);
+
+	// Listens to the changes of every item table of the loaded data asset
+	void BindItemsDataTablesChanged();
+
+	void SetItemsDatabaseState(EGCItemsDatabaseState newState);
+
+	// Returns the cached row of the item, resolving its cooked row or loading its on demand category if needed
+	const FGCItemRowCacheEntry* FindItemRow(const FGameplayTag& itemTag);
+
+	// Returns the on demand category the item belongs to, or an invalid tag if there is none
+	FGameplayTag FindOnDemandItemsCategory(const FGameplayTag& itemTag) const;
+
+	// Loads the on demand category the item belongs to synchronously. Returns false if there is none, it was already loaded or the items database is still loading.
+	bool LoadOnDemandItemsCategory(const FGameplayTag& itemTag);
+
+	// Caches the items of a loaded on demand category and evicts other categories if it goes over the budget
+	void RegisterOnDemandItemsCategory(const FGameplayTag& categoryTag, UDataTable* itemsTable);
+
+	void UnloadOnDemandItemsCategory(const FGameplayTag& categoryTag);
+
+	// Evicts the least recently used on demand categories until the resident bytes fit in the budget
+	void EnforceOnDemandCategoriesBudget(const FGameplayTag& keptCategoryTag);
+
 	bool Generic_GetDataTableRowFromName(const UDataTable* Table, FName RowName, void* OutRowPtr);
 
+	// Registers every row of the category table in the given items information and row cache. Safe to call from a worker thread.
+	static void CacheItemsDataTable(const FGameplayTag& categoryTag, const UDataTable* itemsTable, TMap<FGameplayTag, FItemKeyInfo>& outItemsInformation, TMap<FGameplayTag, FGCItemRowCacheEntry>& outItemRowCache, bool bOnDemandCategory = false);
+
+	// Sorts the known items into the id registry and gives their ids to the recipe ingredients
+	static void BuildItemIds(const TMap<FGameplayTag, FItemKeyInfo>& itemsInformation, FGCCompiledRecipeTable& compiledRecipes, FGCItemIdRegistry& outItemIdRegistry);
+
+	// Drops every cached item of the category, used before re-caching a table that changed
+	void UncacheItemsCategory(const FGameplayTag& categoryTag);
+
+	void HandleItemsDataTableChanged(FGameplayTag categoryTag);
+
+	void ResetItemsInformation();
+
 	/*A data asset which link the fragment type (which is a gameplay tag) with a UScriptStruct.*/
 	UPROPERTY(EditAnywhere, config, Category = Settings)
 	TSoftObjectPtr<UGCInventoryMappingDataAsset> ItemsDataAsset;
 
+	// When enabled the items data asset is streamed and indexed without blocking the game thread during Initialize
+	UPROPERTY(EditAnywhere, config, Category = Settings)
+	bool bInitializeItemsAsynchronously = false;
+
+	// When enabled the items information is read from the database baked by the GCCookItemDatabase commandlet instead of being built at startup
+	UPROPERTY(EditAnywhere, config, Category = Settings)
+	bool bUseCookedItemDatabase = false;
+
+	// Cooked item database path relative to the project directory. Files inside a pak cannot be memory mapped, so packaged builds must stage it
+	// as a loose file. For the default path add this to DefaultGame.ini:
+	// [/Script/UnrealEd.ProjectPackagingSettings]
+	// +DirectoriesToAlwaysStageAsNonUFS=(Path="GCInventory")
+	UPROPERTY(EditAnywhere, config, Category = Settings, meta = (EditCondition = "bUseCookedItemDatabase"))
+	FString CookedItemDatabasePath = TEXT("Content/GCInventory/ItemDatabase.gcdb");
+
+	// Memory budget in bytes for the tables of on demand categories. Least recently used categories are evicted past it, 0 means no budget.
+	UPROPERTY(EditAnywhere, config, Category = Settings, meta = (ClampMin = 0))
+	int64 OnDemandCategoriesMemoryBudget = 0;
+
+	// Time in milliseconds spent every frame broadcasting the deferred item events of the inventories, 0 broadcasts all of them every frame
+	UPROPERTY(EditAnywhere, config, Category = Settings, meta = (ClampMin = 0))
+	float DeferredItemEventsFrameBudgetMs = 1.f;
+
+	// Resolution in seconds of the crafting scheduler, crafting jobs complete on the first tick after their crafting time
+	UPROPERTY(EditAnywhere, config, Category = Settings, meta = (ClampMin = 0.01))
+	float CraftingSchedulerTickInterval = 0.1f;
+
 private:
 
+	// Keeps the data asset (and through it the item tables) alive while rows are cached
+	UPROPERTY(Transient)
+	TObjectPtr<UGCInventoryMappingDataAsset> LoadedItemsDataAsset;
+
 	// Map with all the existing items in the game (defined in the items data asset) with their key info
 	TMap<FGameplayTag, FItemKeyInfo> AllItemsInventory;
+
+	// Row of every item, resolved once so lookups are a single hash probe
+	TMap<FGameplayTag, FGCItemRowCacheEntry> ItemRowCache;
+
+	// Handles to the OnDataTableChanged delegates of the cached tables
+	TMap<TWeakObjectPtr<UDataTable>, FDelegateHandle> ItemsTableChangedHandles;
+
+	// All the recipes of the game, flattened once so crafting queries never touch the data asset
+	FGCCompiledRecipeTable CompiledRecipes;
+
+	FGCRecipeGraph RecipeGraph;
+
+	FGCItemIdRegistry ItemIdRegistry;
+
+	// Strong references to the loaded on demand category tables
+	UPROPERTY(Transient)
+	TMap<FGameplayTag, TObjectPtr<UDataTable>> ResidentOnDemandTables;
+
+	// Usage of the loaded on demand categories
+	TMap<FGameplayTag, FGCOnDemandCategoryResidency> OnDemandCategoriesResidency;
+
+	int64 OnDemandCategoriesResidentBytes = 0;
+
+	EGCItemsDatabaseState ItemsDatabaseState = EGCItemsDatabaseState::Uninitialized;
+
+	FSimpleMulticastDelegate OnItemsDatabaseReadyNative;
+
+	TSharedPtr<FStreamableHandle> ItemsDataAssetHandle;
+
+	FGCCookedItemDatabase CookedItemDatabase;
 };
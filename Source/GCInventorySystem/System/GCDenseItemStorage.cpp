@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GCDenseItemStorage.h"
+
+//////////////////////////////////////////////////////////////////////
+// FGCItemIdRegistry
+
+void FGCItemIdRegistry::Build(TArray<FGameplayTag> ItemTags)
+{
+	ItemTags.Sort([](const FGameplayTag& A, const FGameplayTag& B)
+		{
+			return A.GetTagName().LexicalLess(B.GetTagName());
+		});
+
+	BuildInOrder(ItemTags);
+}
+
+void FGCItemIdRegistry::BuildInOrder(TConstArrayView<FGameplayTag> ItemTags)
+{
+	Reset();
+
+	IdToTag.Reserve(ItemTags.Num());
+	TagToIdMap.Reserve(ItemTags.Num());
+
+	for (const FGameplayTag& ItemTag : ItemTags)
+	{
+		AddItem(ItemTag);
+	}
+}
+
+int32 FGCItemIdRegistry::AddItem(const FGameplayTag& ItemTag)
+{
+	if (const int32* ItemId = TagToIdMap.Find(ItemTag))
+	{
+		return *ItemId;
+	}
+
+	const int32 NewId = IdToTag.Add(ItemTag);
+	TagToIdMap.Add(ItemTag, NewId);
+	return NewId;
+}
+
+void FGCItemIdRegistry::Reset()
+{
+	IdToTag.Reset();
+	TagToIdMap.Reset();
+}
+
+//////////////////////////////////////////////////////////////////////
+// FGCDenseItemStorage
+
+void FGCDenseItemStorage::Reset()
+{
+	Occupancy.Reset();
+	Counts.Reset();
+	NumOccupied = 0;
+}
+
+void FGCDenseItemStorage::SetCount(int32 ItemId, float Count)
+{
+	if (ItemId < 0)
+	{
+		return;
+	}
+
+	if (Count <= 0.0f)
+	{
+		if (Contains(ItemId))
+		{
+			Occupancy[ItemId] = false;
+			Counts[ItemId] = 0.0f;
+			--NumOccupied;
+		}
+		return;
+	}
+
+	if (ItemId >= Occupancy.Num())
+	{
+		Grow(ItemId + 1);
+	}
+
+	if (!Occupancy[ItemId])
+	{
+		Occupancy[ItemId] = true;
+		++NumOccupied;
+	}
+	Counts[ItemId] = Count;
+}
+
+void FGCDenseItemStorage::Grow(int32 NumIds)
+{
+	const int32 NumNewIds = NumIds - Occupancy.Num();
+	if (NumNewIds > 0)
+	{
+		Occupancy.Add(false, NumNewIds);
+		Counts.AddZeroed(NumNewIds);
+	}
+}
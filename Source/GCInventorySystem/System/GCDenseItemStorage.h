@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+#include "Containers/BitArray.h"
+
+/**
+ * Assigns a dense integer id to every item known by the inventory subsystem.
+ * Ids are sorted at initialization so they are stable across runs with the same items,
+ * items discovered later (on demand categories) are appended and never reused.
+ */
+class GCINVENTORYSYSTEM_API FGCItemIdRegistry
+{
+public:
+
+	// Replaces the registry with the given items, sorted by tag name
+	void Build(TArray<FGameplayTag> ItemTags);
+
+	// Replaces the registry with the given items in the given order, which must already be stable across runs (the cooked item database is sorted by net index)
+	void BuildInOrder(TConstArrayView<FGameplayTag> ItemTags);
+
+	// Gives an id to the item if it does not have one yet and returns it
+	int32 AddItem(const FGameplayTag& ItemTag);
+
+	void Reset();
+
+	// Returns the id of the item (or INDEX_NONE if the item is unknown)
+	int32 FindId(const FGameplayTag& ItemTag) const
+	{
+		const int32* ItemId = TagToIdMap.Find(ItemTag);
+		return ItemId ? *ItemId : INDEX_NONE;
+	}
+
+	FGameplayTag GetTag(int32 ItemId) const
+	{
+		return IdToTag.IsValidIndex(ItemId) ? IdToTag[ItemId] : FGameplayTag();
+	}
+
+	int32 Num() const
+	{
+		return IdToTag.Num();
+	}
+
+private:
+
+	TArray<FGameplayTag> IdToTag;
+
+	TMap<FGameplayTag, int32> TagToIdMap;
+};
+
+/**
+ * Item counts indexed by dense item id: an occupancy bitset plus a packed count array.
+ * Lookups are a bounds check and an array read.
+ */
+class GCINVENTORYSYSTEM_API FGCDenseItemStorage
+{
+public:
+
+	void Reset();
+
+	// Sets the count of the item, a count of 0 or less removes it
+	void SetCount(int32 ItemId, float Count);
+
+	float GetCount(int32 ItemId) const
+	{
+		return Occupancy.IsValidIndex(ItemId) && Occupancy[ItemId] ? Counts[ItemId] : 0.0f;
+	}
+
+	bool Contains(int32 ItemId) const
+	{
+		return Occupancy.IsValidIndex(ItemId) && Occupancy[ItemId];
+	}
+
+	int32 NumItems() const
+	{
+		return NumOccupied;
+	}
+
+	const TBitArray<>& GetOccupancy() const
+	{
+		return Occupancy;
+	}
+
+private:
+
+	void Grow(int32 NumIds);
+
+	TBitArray<> Occupancy;
+
+	TArray<float> Counts;
+
+	int32 NumOccupied = 0;
+};
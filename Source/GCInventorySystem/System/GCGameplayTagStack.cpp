@@ -2,10 +2,19 @@
 
 #include "GCGameplayTagStack.h"
 
+#include "Modules/GCInventorySystem.h"
 #include "UObject/Stack.h"
+#include "Math/VectorRegister.h"
+#include "Algo/StableSort.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GCGameplayTagStack)
 
+DECLARE_CYCLE_STAT(TEXT("TagStack AddStack"), STAT_GCTagStack_AddStack, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("TagStack RemoveStack"), STAT_GCTagStack_RemoveStack, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("TagStack ClearStack"), STAT_GCTagStack_ClearStack, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("TagStack ApplyStackDelta"), STAT_GCTagStack_ApplyStackDelta, STATGROUP_GCInventory);
+DECLARE_CYCLE_STAT(TEXT("TagStack NetDeltaSerialize"), STAT_GCTagStack_NetDeltaSerialize, STATGROUP_GCInventory);
+
 //////////////////////////////////////////////////////////////////////
 // FGCGameplayTagStack
 
@@ -16,7 +25,6 @@ FString FGCGameplayTagStack::GetDebugString() const
 
 void FGCGameplayTagStack::PostReplicatedChange(const struct FGCGameplayTagStackContainer& InArraySerializer)
 {
-	//OnChanged.Broadcast();
 }
 
 FGameplayTag FGCGameplayTagStack::GetGameplayTag() const
@@ -29,11 +37,50 @@ float FGCGameplayTagStack::GetStackCount() const
 	return StackCount;
 }
 
+bool FGCGameplayTagStack::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	Tag.NetSerialize(Ar, Map, bOutSuccess);
+
+	// one bit, then a packed whole count or the full float
+	uint8 bWholeCount = 0;
+	if (Ar.IsSaving())
+	{
+		bWholeCount = GCTagStackSerialization::IsWholeCount(StackCount) ? 1 : 0;
+	}
+	Ar.SerializeBits(&bWholeCount, 1);
+
+	if (bWholeCount)
+	{
+		uint32 PackedCount = 0;
+		if (Ar.IsSaving())
+		{
+			PackedCount = GCTagStackSerialization::EncodeWholeCount(StackCount);
+		}
+
+		Ar.SerializeIntPacked(PackedCount);
+
+		if (Ar.IsLoading())
+		{
+			StackCount = GCTagStackSerialization::DecodeWholeCount(PackedCount);
+		}
+	}
+	else
+	{
+		Ar << StackCount;
+	}
+
+	bOutSuccess &= !Ar.IsError();
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 // FGCGameplayTagStackContainer
 
 void FGCGameplayTagStackContainer::AddStack(FGameplayTag Tag, float StackCount)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GCTagStack_AddStack);
+	CSV_SCOPED_TIMING_STAT(GCInventory, AddStack);
+
 	if (!Tag.IsValid())
 	{
 		FFrame::KismetExecutionMessage(TEXT("An invalid tag was passed to AddStack"), ELogVerbosity::Warning);
@@ -42,37 +89,38 @@ void FGCGameplayTagStackContainer::AddStack(FGameplayTag Tag, float StackCount)
 
 	if (StackCount > 0)
 	{
-		for (FGCGameplayTagStack& Stack : Stacks)
+		const int32 Index = FindStackIndex(Tag);
+		if (Index != INDEX_NONE)
 		{
-			if (Stack.Tag == Tag)
-			{
-				const float NewCount = Stack.StackCount + StackCount;
-				Stack.StackCount = NewCount;
-
-				if (TagToCountMap.Contains(Tag))
-				{
-					TagToCountMap[Tag] = NewCount;
-				}
-				else
-				{
-					TagToCountMap.Add(Tag, NewCount);
-				}
-				Stack.OnChanged.Broadcast();
-				MarkItemDirty(Stack);
-				return;
-			}
+			FGCGameplayTagStack& Stack = Stacks[Index];
+			const float OldStackCount = Stack.StackCount;
+			Stack.StackCount += StackCount;
+			AccountStackChange(Tag, OldStackCount, Stack.StackCount, ++Version);
+			SyncDenseStack(Tag, Stack.StackCount);
+			MarkItemDirty(Stack);
+			OnTagStackDirty.ExecuteIfBound(Tag);
+			OnTagStackChanged.Broadcast(Tag);
+			NotifyTagSubscribers(Tag);
+			return;
 		}
 
-		FGCGameplayTagStack& NewStack = Stacks.Emplace_GetRef(Tag, StackCount);
-		MarkItemDirty(NewStack);
-		TagToCountMap.Add(Tag, StackCount);
+		const int32 NewIndex = Stacks.Emplace(Tag, StackCount);
+		RegisterStackIndex(Tag, NewIndex);
+		AccountStackChange(Tag, 0.0f, StackCount, ++Version);
+		MarkItemDirty(Stacks[NewIndex]);
+		SyncDenseStack(Tag, StackCount);
+		OnTagStackDirty.ExecuteIfBound(Tag);
+		OnTagStackChanged.Broadcast(Tag);
 		OnStackItemAdded.Broadcast(Tag);
-		NewStack.OnChanged.Broadcast();
+		NotifyTagSubscribers(Tag);
 	}
 }
 
 void FGCGameplayTagStackContainer::RemoveStack(FGameplayTag Tag, float StackCount)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GCTagStack_RemoveStack);
+	CSV_SCOPED_TIMING_STAT(GCInventory, RemoveStack);
+
 	if (!Tag.IsValid())
 	{
 		FFrame::KismetExecutionMessage(TEXT("An invalid tag was passed to RemoveStack"), ELogVerbosity::Warning);
@@ -82,36 +130,197 @@ void FGCGameplayTagStackContainer::RemoveStack(FGameplayTag Tag, float StackCoun
 	//@TODO: Should we error if you try to remove a stack that doesn't exist or has a smaller count?
 	if (StackCount > 0)
 	{
-		for (auto It = Stacks.CreateIterator(); It; ++It)
+		const int32 Index = FindStackIndex(Tag);
+		if (Index != INDEX_NONE)
 		{
-			FGCGameplayTagStack& Stack = *It;
-			if (Stack.Tag == Tag)
+			FGCGameplayTagStack& Stack = Stacks[Index];
+			if (Stack.StackCount <= StackCount)
+			{
+				AccountStackChange(Tag, Stack.StackCount, 0.0f, ++Version);
+				SyncDenseStack(Tag, 0.0f);
+				RemoveStackAtSwap(Index);
+				MarkArrayDirty();
+			}
+			else
 			{
-				if (Stack.StackCount <= StackCount)
-				{
-					It.RemoveCurrent();
-					TagToCountMap.Remove(Tag);
-					MarkArrayDirty();
-				}
-				else
-				{
-					const float NewCount = Stack.StackCount - StackCount;
-					Stack.StackCount = NewCount;
-					TagToCountMap[Tag] = NewCount;
-					MarkItemDirty(Stack);
-				}
-				Stack.OnChanged.Broadcast();
-				return;
+				const float OldStackCount = Stack.StackCount;
+				Stack.StackCount -= StackCount;
+				AccountStackChange(Tag, OldStackCount, Stack.StackCount, ++Version);
+				SyncDenseStack(Tag, Stack.StackCount);
+				MarkItemDirty(Stack);
 			}
+
+			OnTagStackDirty.ExecuteIfBound(Tag);
+			OnTagStackChanged.Broadcast(Tag);
+			NotifyTagSubscribers(Tag);
 		}
 	}
 }
 
 void FGCGameplayTagStackContainer::ClearStack()
 {
-	for (FGCGameplayTagStack& Stack : Stacks)
+	SCOPE_CYCLE_COUNTER(STAT_GCTagStack_ClearStack);
+	CSV_SCOPED_TIMING_STAT(GCInventory, ClearStack);
+
+	if (Stacks.Num() > 0)
 	{
-		RemoveStack(Stack.Tag, Stack.StackCount);
+		// subscribers are notified once the stacks are gone
+		TArray<FGameplayTag, TInlineAllocator<16>> ClearedTags;
+		if (TagSubscriptions.Num() > 0)
+		{
+			for (const FGCGameplayTagStack& Stack : Stacks)
+			{
+				ClearedTags.Add(Stack.Tag);
+			}
+		}
+
+		++Version;
+		if (Journal.Num() > 0)
+		{
+			for (const FGCGameplayTagStack& Stack : Stacks)
+			{
+				JournalChange(Stack.Tag, Stack.StackCount, 0.0f, Version);
+			}
+		}
+
+		Stacks.Reset();
+		TagToIndexMap.Reset();
+		InlineTagKeys.Reset();
+		InlineLiveSlots.Reset();
+		bUseTagIndexMap = false;
+		DenseStacks.Reset();
+		AccountedStackCounts.Reset();
+		TotalStackCount = 0.0;
+		MarkArrayDirty();
+		OnTagStackDirty.ExecuteIfBound(FGameplayTag());
+		OnTagStackChanged.Broadcast(FGameplayTag());
+
+		for (const FGameplayTag& Tag : ClearedTags)
+		{
+			NotifyTagSubscribers(Tag);
+		}
+	}
+}
+
+void FGCGameplayTagStackContainer::ApplyStackDelta(const TMap<FGameplayTag, float>& StacksToRemove, const TMap<FGameplayTag, float>& StacksToAdd)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCTagStack_ApplyStackDelta);
+	CSV_SCOPED_TIMING_STAT(GCInventory, ApplyStackDelta);
+
+	// a set keeps big deltas linear, and without removals it iterates in insertion order like the arrays
+	TSet<FGameplayTag, DefaultKeyFuncs<FGameplayTag>, TInlineSetAllocator<16>> ChangedTags;
+	TArray<FGameplayTag, TInlineAllocator<16>> AddedTags;
+	TArray<FGameplayTag, TInlineAllocator<16>> RemovedTags;
+
+	// every change of the delta shares one version
+	const int32 DeltaVersion = Version + 1;
+
+	for (const auto& Element : StacksToRemove)
+	{
+		const int32 Index = FindStackIndex(Element.Key);
+		if (Index == INDEX_NONE || Element.Value <= 0)
+		{
+			continue;
+		}
+
+		FGCGameplayTagStack& Stack = Stacks[Index];
+		if (Stack.StackCount <= Element.Value)
+		{
+			AccountStackChange(Element.Key, Stack.StackCount, 0.0f, DeltaVersion);
+			SyncDenseStack(Element.Key, 0.0f);
+			RemoveStackAtSwap(Index);
+			RemovedTags.Add(Element.Key);
+		}
+		else
+		{
+			const float OldStackCount = Stack.StackCount;
+			Stack.StackCount -= Element.Value;
+			AccountStackChange(Element.Key, OldStackCount, Stack.StackCount, DeltaVersion);
+			SyncDenseStack(Element.Key, Stack.StackCount);
+			ChangedTags.Add(Element.Key);
+		}
+	}
+
+	for (const auto& Element : StacksToAdd)
+	{
+		if (!Element.Key.IsValid() || Element.Value <= 0)
+		{
+			continue;
+		}
+
+		const int32 Index = FindStackIndex(Element.Key);
+		if (Index != INDEX_NONE)
+		{
+			FGCGameplayTagStack& Stack = Stacks[Index];
+			const float OldStackCount = Stack.StackCount;
+			Stack.StackCount += Element.Value;
+			AccountStackChange(Element.Key, OldStackCount, Stack.StackCount, DeltaVersion);
+			SyncDenseStack(Element.Key, Stack.StackCount);
+		}
+		else
+		{
+			RegisterStackIndex(Element.Key, Stacks.Emplace(Element.Key, Element.Value));
+			AccountStackChange(Element.Key, 0.0f, Element.Value, DeltaVersion);
+			SyncDenseStack(Element.Key, Element.Value);
+			AddedTags.Add(Element.Key);
+		}
+		ChangedTags.Add(Element.Key);
+	}
+
+	if (ChangedTags.Num() > 0 || RemovedTags.Num() > 0)
+	{
+		Version = DeltaVersion;
+	}
+
+	// single dirty pass once every stack holds its final value
+	for (const FGameplayTag& Tag : ChangedTags)
+	{
+		const int32 Index = FindStackIndex(Tag);
+		if (Index != INDEX_NONE)
+		{
+			MarkItemDirty(Stacks[Index]);
+		}
+	}
+
+	if (RemovedTags.Num() > 0)
+	{
+		MarkArrayDirty();
+	}
+
+	// a removed stack added back by the same delta is notified with the changed ones
+	RemovedTags.RemoveAll([&ChangedTags](const FGameplayTag& Tag)
+		{
+			return ChangedTags.Contains(Tag);
+		});
+
+	if (OnTagStackDirty.IsBound() || OnTagStackChanged.IsBound())
+	{
+		for (const FGameplayTag& Tag : RemovedTags)
+		{
+			OnTagStackDirty.ExecuteIfBound(Tag);
+			OnTagStackChanged.Broadcast(Tag);
+		}
+
+		for (const FGameplayTag& Tag : ChangedTags)
+		{
+			OnTagStackDirty.ExecuteIfBound(Tag);
+			OnTagStackChanged.Broadcast(Tag);
+		}
+	}
+
+	for (const FGameplayTag& Tag : AddedTags)
+	{
+		OnStackItemAdded.Broadcast(Tag);
+	}
+
+	for (const FGameplayTag& Tag : RemovedTags)
+	{
+		NotifyTagSubscribers(Tag);
+	}
+
+	for (const FGameplayTag& Tag : ChangedTags)
+	{
+		NotifyTagSubscribers(Tag);
 	}
 }
 
@@ -120,13 +329,268 @@ const TArray<FGCGameplayTagStack>& FGCGameplayTagStackContainer::GetGameplayTagS
 	return Stacks;
 }
 
+void FGCGameplayTagStackContainer::SetJournalCapacity(int32 Capacity)
+{
+	Capacity = FMath::Max(Capacity, 0);
+	if (Capacity == Journal.Num())
+	{
+		return;
+	}
+
+	Journal.Reset();
+	Journal.SetNum(Capacity);
+	NextJournalEntry = 0;
+	NumJournalEntries = 0;
+	JournalStartVersion = Version;
+}
+
+void FGCGameplayTagStackContainer::GetChangesSince(int32 SinceVersion, FGCTagStackDiff& OutDiff) const
+{
+	OutDiff.Version = Version;
+	OutDiff.Changes.Reset();
+
+	if (SinceVersion == Version)
+	{
+		OutDiff.bIsFullSnapshot = false;
+		return;
+	}
+
+	// a version the container never had (from another session or another container) cannot be diffed either
+	OutDiff.bIsFullSnapshot = Journal.Num() == 0 || SinceVersion < JournalStartVersion || SinceVersion > Version;
+
+	if (OutDiff.bIsFullSnapshot)
+	{
+		OutDiff.Changes.Reserve(Stacks.Num());
+		for (const FGCGameplayTagStack& Stack : Stacks)
+		{
+			FGCTagStackJournalEntry& Entry = OutDiff.Changes.AddDefaulted_GetRef();
+			Entry.Tag = Stack.Tag;
+			Entry.NewStackCount = Stack.StackCount;
+			Entry.Version = Version;
+		}
+		return;
+	}
+
+	// walks back from the newest change until the requested version, so only the changes returned are visited
+	const int32 Capacity = Journal.Num();
+	int32 NumChanges = 0;
+	while (NumChanges < NumJournalEntries && Journal[(NextJournalEntry - 1 - NumChanges + Capacity) % Capacity].Version > SinceVersion)
+	{
+		++NumChanges;
+	}
+
+	OutDiff.Changes.Reserve(NumChanges);
+	for (int32 ChangeIndex = NumChanges; ChangeIndex > 0; --ChangeIndex)
+	{
+		OutDiff.Changes.Add(Journal[(NextJournalEntry - ChangeIndex + Capacity) % Capacity]);
+	}
+}
+
+void FGCGameplayTagStackContainer::AccountStackChange(const FGameplayTag& Tag, float OldStackCount, float NewStackCount, int32 ChangeVersion)
+{
+	TotalStackCount += NewStackCount - OldStackCount;
+
+	if (bReceivesReplicatedStacks)
+	{
+		if (NewStackCount > 0.0f)
+		{
+			AccountedStackCounts.Add(Tag, NewStackCount);
+		}
+		else
+		{
+			AccountedStackCounts.Remove(Tag);
+		}
+	}
+
+	JournalChange(Tag, OldStackCount, NewStackCount, ChangeVersion);
+}
+
+void FGCGameplayTagStackContainer::SetReceivesReplicatedStacks(bool bReceives)
+{
+	bReceivesReplicatedStacks = bReceives;
+	AccountedStackCounts.Reset();
+
+	if (bReceivesReplicatedStacks)
+	{
+		AccountedStackCounts.Reserve(Stacks.Num());
+
+		for (const FGCGameplayTagStack& Stack : Stacks)
+		{
+			AccountedStackCounts.Add(Stack.Tag, Stack.StackCount);
+		}
+	}
+}
+
+float FGCGameplayTagStackContainer::GetAccountedStackCount(const FGCGameplayTagStack& Stack) const
+{
+	// without the accounted counts the stack itself is the best guess, which is right as long as updates are applied in place
+	const float* AccountedStackCount = AccountedStackCounts.Find(Stack.Tag);
+	return AccountedStackCount ? *AccountedStackCount : (bReceivesReplicatedStacks ? 0.0f : Stack.StackCount);
+}
+
+void FGCGameplayTagStackContainer::JournalChange(const FGameplayTag& Tag, float OldStackCount, float NewStackCount, int32 ChangeVersion)
+{
+	if (Journal.Num() == 0)
+	{
+		return;
+	}
+
+	FGCTagStackJournalEntry& Entry = Journal[NextJournalEntry];
+	if (NumJournalEntries == Journal.Num())
+	{
+		// the other changes of the overwritten version may still be journaled, but not all of them
+		JournalStartVersion = Entry.Version;
+	}
+	else
+	{
+		++NumJournalEntries;
+	}
+
+	Entry.Tag = Tag;
+	Entry.OldStackCount = OldStackCount;
+	Entry.NewStackCount = NewStackCount;
+	Entry.Version = ChangeVersion;
+
+	NextJournalEntry = (NextJournalEntry + 1) % Journal.Num();
+}
+
+void FGCGameplayTagStackContainer::EnableDenseStorage(const FGCItemIdRegistry* InItemIdRegistry)
+{
+	ItemIdRegistry = InItemIdRegistry;
+	DenseStacks.Reset();
+
+	for (const FGCGameplayTagStack& Stack : Stacks)
+	{
+		SyncDenseStack(Stack.Tag, Stack.StackCount);
+	}
+}
+
+void FGCGameplayTagStackContainer::RemoveStackAtSwap(int32 Index)
+{
+	if (!bUseTagIndexMap)
+	{
+		// the keys mirror the slots, so they are swapped the same way
+		InlineTagKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		InlineLiveSlots.RemoveAtSwap(Index);
+		Stacks.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		return;
+	}
+
+	TagToIndexMap.Remove(Stacks[Index].Tag);
+
+	Stacks.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	// the last stack now lives in the removed slot
+	if (Stacks.IsValidIndex(Index))
+	{
+		TagToIndexMap[Stacks[Index].Tag] = Index;
+	}
+}
+
+int32 FGCGameplayTagStackContainer::FindInlineStackIndex(const FGameplayTag& Tag) const
+{
+	const uint32 Key = GetTypeHash(Tag);
+	const uint32* Keys = InlineTagKeys.GetData();
+	const int32 NumKeys = InlineTagKeys.Num();
+	int32 Index = 0;
+
+	const VectorRegister4Int KeyVector = VectorIntSet1(static_cast<int32>(Key));
+
+	for (; Index + 4 <= NumKeys; Index += 4)
+	{
+		const VectorRegister4Int Matches = VectorIntCompareEQ(VectorIntLoad(Keys + Index), KeyVector);
+		uint32 MatchMask = static_cast<uint32>(VectorMaskBits(VectorCast4IntTo4Float(Matches)));
+
+		// different tags may share a hash, so every match is confirmed against the stack
+		while (MatchMask != 0)
+		{
+			const int32 MatchIndex = Index + static_cast<int32>(FMath::CountTrailingZeros(MatchMask));
+			if (InlineLiveSlots[MatchIndex] && Stacks[MatchIndex].Tag == Tag)
+			{
+				return MatchIndex;
+			}
+			MatchMask &= MatchMask - 1;
+		}
+	}
+
+	for (; Index < NumKeys; ++Index)
+	{
+		if (Keys[Index] == Key && InlineLiveSlots[Index] && Stacks[Index].Tag == Tag)
+		{
+			return Index;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void FGCGameplayTagStackContainer::RegisterStackIndex(const FGameplayTag& Tag, int32 Index)
+{
+	if (bUseTagIndexMap)
+	{
+		TagToIndexMap.Add(Tag, Index);
+		return;
+	}
+
+	if (Index >= InlineTagKeys.Num())
+	{
+		InlineTagKeys.SetNumZeroed(Index + 1, EAllowShrinking::No);
+		InlineLiveSlots.SetNum(Index + 1, false);
+	}
+	InlineTagKeys[Index] = GetTypeHash(Tag);
+	InlineLiveSlots[Index] = true;
+
+	if (Stacks.Num() > InlineStackThreshold)
+	{
+		// slots pending removal or not registered yet must stay unreachable
+		TagToIndexMap.Reserve(Stacks.Num());
+		for (TConstSetBitIterator<TInlineAllocator<1>> It(InlineLiveSlots); It; ++It)
+		{
+			TagToIndexMap.Add(Stacks[It.GetIndex()].Tag, It.GetIndex());
+		}
+
+		InlineTagKeys.Empty();
+		InlineLiveSlots.Empty();
+		bUseTagIndexMap = true;
+	}
+}
+
+void FGCGameplayTagStackContainer::UnregisterStackIndex(const FGameplayTag& Tag, int32 Index)
+{
+	if (bUseTagIndexMap)
+	{
+		TagToIndexMap.Remove(Tag);
+	}
+	else if (InlineLiveSlots.IsValidIndex(Index))
+	{
+		InlineLiveSlots[Index] = false;
+	}
+}
+
+void FGCGameplayTagStackContainer::RebuildStackLookup()
+{
+	TagToIndexMap.Reset();
+	InlineTagKeys.Reset();
+	InlineLiveSlots.Reset();
+	bUseTagIndexMap = false;
+
+	for (int32 Index = 0; Index < Stacks.Num(); ++Index)
+	{
+		RegisterStackIndex(Stacks[Index].Tag, Index);
+	}
+}
+
 void FGCGameplayTagStackContainer::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
 {
 	for (int32 Index : RemovedIndices)
 	{
 		const FGameplayTag Tag = Stacks[Index].Tag;
-		TagToCountMap.Remove(Tag);
-		Stacks[Index].OnChanged.Broadcast();
+		UnregisterStackIndex(Tag, Index);
+		SyncDenseStack(Tag, 0.0f);
+		AccountStackChange(Tag, GetAccountedStackCount(Stacks[Index]), 0.0f, ++Version);
+		PendingReplicatedRemovals.Add(Index);
+		AddReplicatedChange(Tag, 0.0f, EGCTagStackChangeType::Removed);
+		NotifyTagSubscribers(Tag);
 		OnTagStackUpdated.ExecuteIfBound(Tag, static_cast<int32>(0));
 	}
 }
@@ -135,9 +599,14 @@ void FGCGameplayTagStackContainer::PostReplicatedAdd(const TArrayView<int32> Add
 {
 	for (int32 Index : AddedIndices)
 	{
-		const FGCGameplayTagStack& Stack = Stacks[Index];
-		TagToCountMap.Add(Stack.Tag, Stack.StackCount);
+		FGCGameplayTagStack& Stack = Stacks[Index];
+		RegisterStackIndex(Stack.Tag, Index);
+		SyncDenseStack(Stack.Tag, Stack.StackCount);
+		// received stacks are new items, whatever they held before is unknown
+		AccountStackChange(Stack.Tag, 0.0f, Stack.StackCount, ++Version);
+		AddReplicatedChange(Stack.Tag, Stack.StackCount, EGCTagStackChangeType::Added);
 		OnStackItemAdded.Broadcast(Stack.Tag);
+		NotifyTagSubscribers(Stack.Tag);
 		OnTagStackUpdated.ExecuteIfBound(Stack.Tag, Stack.StackCount);
 	}
 }
@@ -148,57 +617,315 @@ void FGCGameplayTagStackContainer::PostReplicatedChange(const TArrayView<int32>
 	{
 		if (Stacks.IsValidIndex(Index))
 		{
-			const FGCGameplayTagStack& Stack = Stacks[Index];
-			TagToCountMap[Stack.Tag] = Stack.StackCount;
-			Stack.OnChanged.Broadcast();
+			FGCGameplayTagStack& Stack = Stacks[Index];
+			RegisterStackIndex(Stack.Tag, Index);
+			SyncDenseStack(Stack.Tag, Stack.StackCount);
+			AccountStackChange(Stack.Tag, GetAccountedStackCount(Stack), Stack.StackCount, ++Version);
+			AddReplicatedChange(Stack.Tag, Stack.StackCount, EGCTagStackChangeType::Changed);
+			NotifyTagSubscribers(Stack.Tag);
 			OnTagStackUpdated.ExecuteIfBound(Stack.Tag, Stack.StackCount);
 		}
 	}
 }
 
-FGCGameplayTagStack* FGCGameplayTagStackContainer::GetTagStackItem(const FGameplayTag& tag)
+void FGCGameplayTagStackContainer::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
 {
-	for (auto It = Stacks.CreateIterator(); It; ++It)
+	if (!bUseTagIndexMap)
+	{
+		// the inline keys are positional, rebuilding them is cheaper than replaying the swaps
+		if (PendingReplicatedRemovals.Num() > 0 || InlineTagKeys.Num() != Stacks.Num())
+		{
+			RebuildStackLookup();
+		}
+	}
+	else
 	{
-		FGCGameplayTagStack& Stack = *It;
-		if (Stack.Tag == tag)
+		// The fast array removes stacks with RemoveAtSwap, so the only stacks that changed slot are the ones that were moved into a removed slot
+		for (const int32 Index : PendingReplicatedRemovals)
 		{
-			return &Stack;
+			if (Stacks.IsValidIndex(Index))
+			{
+				TagToIndexMap.Add(Stacks[Index].Tag, Index);
+			}
 		}
 	}
-	return nullptr;
+
+	PendingReplicatedRemovals.Reset();
+
+	if (!bDeferReplicatedChanges)
+	{
+		FlushReplicatedChanges();
+	}
+
+	OnReplicatedReceive.ExecuteIfBound();
 }
 
-void FGCGameplayTagStackContainer::BindDelegateToStackReplicated(const FGameplayTag& tag, const FDynamicOnStackItemReplicated& onStackItemReplicated, const UObject* ownerUObject)
+void FGCGameplayTagStackContainer::AddReplicatedChange(const FGameplayTag& Tag, float StackCount, EGCTagStackChangeType ChangeType)
 {
-	auto tagStack = GetTagStackItem(tag);
-	if (tagStack)
+	if (!OnStacksReplicated.IsBound())
 	{
-		tagStack->OnChanged.AddWeakLambda(ownerUObject,
-			[onStackItemReplicated]()
-			{
-				onStackItemReplicated.ExecuteIfBound();
-			});
+		return;
 	}
-	else
+
+	const int32* PendingIndex = PendingReplicatedChangeIndices.Find(Tag);
+	if (!PendingIndex)
+	{
+		PendingReplicatedChangeIndices.Add(Tag, PendingReplicatedChanges.Num());
+
+		FGCTagStackChange& NewChange = PendingReplicatedChanges.AddDefaulted_GetRef();
+		NewChange.Tag = Tag;
+		NewChange.StackCount = StackCount;
+		NewChange.ChangeType = ChangeType;
+		return;
+	}
+
+	// listeners only care about the net result: a removed and added back stack changed, a changed new stack is still new
+	FGCTagStackChange& PendingChange = PendingReplicatedChanges[*PendingIndex];
+	if (ChangeType == EGCTagStackChangeType::Added && PendingChange.ChangeType == EGCTagStackChangeType::Removed)
+	{
+		ChangeType = EGCTagStackChangeType::Changed;
+	}
+	else if (ChangeType == EGCTagStackChangeType::Changed && PendingChange.ChangeType == EGCTagStackChangeType::Added)
+	{
+		ChangeType = EGCTagStackChangeType::Added;
+	}
+
+	PendingChange.StackCount = StackCount;
+	PendingChange.ChangeType = ChangeType;
+}
+
+void FGCGameplayTagStackContainer::FlushReplicatedChanges()
+{
+	if (PendingReplicatedChanges.Num() == 0)
+	{
+		return;
+	}
+
+	// listeners may trigger another replication update, so the changes are moved out first
+	TArray<FGCTagStackChange> Changes = MoveTemp(PendingReplicatedChanges);
+	PendingReplicatedChanges.Reset();
+	PendingReplicatedChangeIndices.Reset();
+
+	OnStacksReplicated.Broadcast(Changes);
+}
+
+bool FGCGameplayTagStackContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GCTagStack_NetDeltaSerialize);
+	CSV_SCOPED_TIMING_STAT(GCInventory, NetDeltaSerialize);
+
+	// connections that are done with their initial sync get the regular delta, whatever the number of changed stacks
+	const FNetFastTArrayBaseState* OldState = static_cast<const FNetFastTArrayBaseState*>(DeltaParms.OldState);
+	if (!DeltaParms.Writer || InitialSyncChunkSize <= 0 || Stacks.Num() <= InitialSyncChunkSize || !IsInitialSyncBaseline(OldState) || !SelectInitialSyncChunk(OldState))
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FGCGameplayTagStack, FGCGameplayTagStackContainer>(Stacks, DeltaParms, *this);
+	}
+
+	// the stacks left out by ShouldWriteFastArrayItem are simply unknown to the connection, they are picked up by the next updates
+	InitialSyncChunkBaseline = OldState;
+	bWritingInitialSyncChunk = true;
+
+	const bool bWroteChanges = FFastArraySerializer::FastArrayDeltaSerialize<FGCGameplayTagStack, FGCGameplayTagStackContainer>(Stacks, DeltaParms, *this);
+
+	bWritingInitialSyncChunk = false;
+	InitialSyncChunkBaseline = nullptr;
+	InitialSyncChunkIDs.Reset();
+
+	if (DeltaParms.NewState && DeltaParms.NewState->IsValid())
+	{
+		ChunkedBaselines.Add(*DeltaParms.NewState);
+	}
+
+	// the array must look changed to the connection on the next update, otherwise its up to date baseline would skip the remaining stacks
+	MarkArrayDirty();
+	bInitialSyncPending = true;
+
+	return bWroteChanges;
+}
+
+bool FGCGameplayTagStackContainer::IsInitialSyncBaseline(const FNetFastTArrayBaseState* OldState)
+{
+	if (!OldState)
 	{
-		OnStackItemAdded.AddWeakLambda(ownerUObject,
-			[onStackItemReplicated, tag, ownerUObject, this](const FGameplayTag& broadCastTag)
+		return true;
+	}
+
+	bool bChunkedBaseline = false;
+
+	// a baseline is only replaced once, so it is forgotten as soon as it is found, along with the baselines of closed connections
+	for (int32 Index = ChunkedBaselines.Num() - 1; Index >= 0; --Index)
+	{
+		const TSharedPtr<INetDeltaBaseState> Baseline = ChunkedBaselines[Index].Pin();
+		if (!Baseline.IsValid() || Baseline.Get() == OldState)
+		{
+			bChunkedBaseline |= Baseline.IsValid();
+			ChunkedBaselines.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+
+	return bChunkedBaseline;
+}
+
+bool FGCGameplayTagStackContainer::SelectInitialSyncChunk(const FNetFastTArrayBaseState* OldState)
+{
+	InitialSyncChunkIDs.Reset();
+
+	for (const int32 Index : GetPrioritizedSlots())
+	{
+		const FGCGameplayTagStack& Stack = Stacks[Index];
+		if (OldState && OldState->IDToCWMap.Contains(Stack.ReplicationID))
+		{
+			continue;
+		}
+
+		if (InitialSyncChunkIDs.Num() == InitialSyncChunkSize)
+		{
+			return true;
+		}
+
+		InitialSyncChunkIDs.Add(Stack.ReplicationID);
+	}
+
+	InitialSyncChunkIDs.Reset();
+	return false;
+}
+
+const TArray<int32>& FGCGameplayTagStackContainer::GetPrioritizedSlots()
+{
+	if (PrioritizedSlotsVersion == Version && PrioritizedSlots.Num() == Stacks.Num())
+	{
+		return PrioritizedSlots;
+	}
+
+	PrioritizedSlots.SetNumUninitialized(Stacks.Num());
+	for (int32 Index = 0; Index < Stacks.Num(); ++Index)
+	{
+		PrioritizedSlots[Index] = Index;
+	}
+
+	if (InitialSyncPriority)
+	{
+		TArray<int32> Priorities;
+		Priorities.SetNumUninitialized(Stacks.Num());
+		for (int32 Index = 0; Index < Stacks.Num(); ++Index)
+		{
+			Priorities[Index] = InitialSyncPriority(Stacks[Index].Tag);
+		}
+
+		Algo::StableSort(PrioritizedSlots, [&Priorities](int32 A, int32 B)
 			{
-				if (tag == broadCastTag)
-				{
-					if (auto tagStackItem = this->GetTagStackItem(tag))
-					{
-						tagStackItem->OnChanged.AddWeakLambda(ownerUObject,
-							[onStackItemReplicated]()
-							{
-								onStackItemReplicated.ExecuteIfBound();
-							});
-						tagStackItem->OnChanged.Broadcast();
-					}
-				}
+				return Priorities[A] < Priorities[B];
 			});
 	}
+
+	PrioritizedSlotsVersion = Version;
+	return PrioritizedSlots;
+}
+
+void FGCGameplayTagStackContainer::GetInitialSyncOrder(TArray<FGameplayTag>& OutTags)
+{
+	OutTags.Reset(Stacks.Num());
+
+	for (const int32 Index : GetPrioritizedSlots())
+	{
+		OutTags.Add(Stacks[Index].Tag);
+	}
+}
+
+FGCGameplayTagStack* FGCGameplayTagStackContainer::GetTagStackItem(const FGameplayTag& tag)
+{
+	const int32 Index = FindStackIndex(tag);
+	return Index != INDEX_NONE ? &Stacks[Index] : nullptr;
+}
+
+FDelegateHandle FGCGameplayTagStackContainer::SubscribeToTag(const FGameplayTag& Tag, FOnStackItemReplicated::FDelegate&& Delegate)
+{
+	TSharedRef<FOnStackItemReplicated>* Subscribers = TagSubscriptions.Find(Tag);
+	if (!Subscribers)
+	{
+		Subscribers = &TagSubscriptions.Add(Tag, MakeShared<FOnStackItemReplicated>());
+	}
+
+	return (*Subscribers)->Add(MoveTemp(Delegate));
+}
+
+void FGCGameplayTagStackContainer::UnsubscribeFromTag(const FGameplayTag& Tag, FDelegateHandle Handle)
+{
+	DynamicTagSubscriptions.RemoveAllSwap([&Handle](const FDynamicTagSubscription& Subscription)
+		{
+			return Subscription.Handle == Handle;
+		}, EAllowShrinking::No);
+
+	if (const TSharedRef<FOnStackItemReplicated>* Subscribers = TagSubscriptions.Find(Tag))
+	{
+		(*Subscribers)->Remove(Handle);
+
+		if (!(*Subscribers)->IsBound())
+		{
+			TagSubscriptions.Remove(Tag);
+		}
+	}
+}
+
+void FGCGameplayTagStackContainer::UnsubscribeFromTag(const FGameplayTag& Tag, const void* UserObject)
+{
+	DynamicTagSubscriptions.RemoveAllSwap([&Tag, UserObject](const FDynamicTagSubscription& Subscription)
+		{
+			return Subscription.Tag == Tag && Subscription.Owner.Get() == UserObject;
+		}, EAllowShrinking::No);
+
+	if (const TSharedRef<FOnStackItemReplicated>* Subscribers = TagSubscriptions.Find(Tag))
+	{
+		(*Subscribers)->RemoveAll(UserObject);
+
+		if (!(*Subscribers)->IsBound())
+		{
+			TagSubscriptions.Remove(Tag);
+		}
+	}
+}
+
+void FGCGameplayTagStackContainer::NotifyTagSubscribers(const FGameplayTag& Tag)
+{
+	const TSharedRef<FOnStackItemReplicated>* FoundSubscribers = TagSubscriptions.Find(Tag);
+	if (!FoundSubscribers)
+	{
+		return;
+	}
+
+	// subscribers may (un)subscribe while being notified, which can reallocate the map
+	const TSharedRef<FOnStackItemReplicated> Subscribers = *FoundSubscribers;
+	Subscribers->Broadcast();
+
+	// the broadcast compacts the subscribers whose owner is gone
+	if (!Subscribers->IsBound())
+	{
+		TagSubscriptions.Remove(Tag);
+	}
+}
+
+FDelegateHandle FGCGameplayTagStackContainer::BindDelegateToStackReplicated(const FGameplayTag& tag, const FDynamicOnStackItemReplicated& onStackItemReplicated, const UObject* ownerUObject)
+{
+	// subscriptions of destroyed owners otherwise stay around until their tag is broadcast
+	for (int32 Index = DynamicTagSubscriptions.Num() - 1; Index >= 0; --Index)
+	{
+		// copied, unsubscribing removes it from the array
+		const FDynamicTagSubscription Subscription = DynamicTagSubscriptions[Index];
+		if (!Subscription.Owner.IsValid())
+		{
+			UnsubscribeFromTag(Subscription.Tag, Subscription.Handle);
+		}
+	}
+
+	const FDelegateHandle Handle = SubscribeToTag(tag, FOnStackItemReplicated::FDelegate::CreateWeakLambda(ownerUObject,
+		[onStackItemReplicated]()
+		{
+			onStackItemReplicated.ExecuteIfBound();
+		}));
+
+	DynamicTagSubscriptions.Add({ tag, Handle, ownerUObject });
+
+	return Handle;
 }
 
 void FGCGameplayTagStackContainer::BindDelegateToOnTagStackUpdated(FOnTagStackUpdatedDynamicDelegate eventCallbackDelegate)
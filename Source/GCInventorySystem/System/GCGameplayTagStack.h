@@ -4,20 +4,143 @@
 
 #include "GameplayTagContainer.h"
 #include "Net/Serialization/FastArraySerializer.h"
+#include "GCDenseItemStorage.h"
 
 #include "GCGameplayTagStack.generated.h"
 
 struct FGCGameplayTagStackContainer;
 struct FNetDeltaSerializeInfo;
+namespace UE::Net { struct FGCGameplayTagStackNetSerializer; }
+
+// Encoding of the stack counts shared by FGCGameplayTagStack::NetSerialize and its Iris serializer, so both put the same counts on the wire
+namespace GCTagStackSerialization
+{
+	// Counts are nearly always whole numbers, which fit in a few bytes once packed
+	inline bool IsWholeCount(float StackCount)
+	{
+		return FMath::Abs(StackCount) < static_cast<float>(MAX_int32) && FMath::RoundToFloat(StackCount) == StackCount;
+	}
+
+	// Zigzag encodes the whole count so small negative counts also pack into few bytes
+	inline uint32 EncodeWholeCount(float StackCount)
+	{
+		const int32 WholeCount = FMath::RoundToInt(StackCount);
+		return (static_cast<uint32>(WholeCount) << 1) ^ static_cast<uint32>(WholeCount >> 31);
+	}
+
+	inline float DecodeWholeCount(uint32 PackedCount)
+	{
+		return static_cast<float>(static_cast<int32>(PackedCount >> 1) ^ -static_cast<int32>(PackedCount & 1));
+	}
+}
 
 DECLARE_MULTICAST_DELEGATE(FOnStackItemReplicated);
 DECLARE_DYNAMIC_DELEGATE(FDynamicOnStackItemReplicated);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnStackItemAdded, const FGameplayTag& tag);
 
+// called after a local change of the stack of the tag was marked for replication (an invalid tag means every stack changed)
+DECLARE_DELEGATE_OneParam(FOnTagStackDirty, const FGameplayTag& tag);
+
+// called once a local change of the stack of the tag is applied (an invalid tag means every stack changed)
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTagStackChanged, const FGameplayTag& tag);
+
 // allows clients to get notification whenever a tag stack is updated
 DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnTagStackUpdatedDynamicDelegate, const FGameplayTag&, tag, const float, amount);
 DECLARE_DELEGATE_TwoParams(FOnTagStackUpdatedDelegate, const FGameplayTag& tag, const float amount);
 
+UENUM(BlueprintType)
+enum class EGCTagStackChangeType : uint8
+{
+	Added,
+	Changed,
+	Removed
+};
+
+/**
+ * Replicated change of one tag stack, changes of the same tag are coalesced into one
+ */
+USTRUCT(BlueprintType)
+struct GCINVENTORYSYSTEM_API FGCTagStackChange
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	FGameplayTag Tag;
+
+	// Stack count after the change, 0 when the stack was removed
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	float StackCount = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	EGCTagStackChangeType ChangeType = EGCTagStackChangeType::Changed;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTagStacksReplicated, TConstArrayView<FGCTagStackChange> changes);
+
+/**
+ * Event bound to the updates of one item stack, used to unbind that event alone
+ */
+USTRUCT(BlueprintType)
+struct GCINVENTORYSYSTEM_API FGCItemUpdatedEventHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	FGameplayTag ItemTag;
+
+	FDelegateHandle Handle;
+
+	bool IsValid() const
+	{
+		return Handle.IsValid();
+	}
+};
+
+/**
+ * Change of one tag stack kept in the journal of the container
+ */
+USTRUCT(BlueprintType)
+struct GCINVENTORYSYSTEM_API FGCTagStackJournalEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	FGameplayTag Tag;
+
+	// Stack count before the change, 0 when the stack was added
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	float OldStackCount = 0.0f;
+
+	// Stack count after the change, 0 when the stack was removed
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	float NewStackCount = 0.0f;
+
+	// Version of the container right after the change, changes applied together share it
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	int32 Version = 0;
+};
+
+/**
+ * Changes of the stacks between two versions of the container
+ */
+USTRUCT(BlueprintType)
+struct GCINVENTORYSYSTEM_API FGCTagStackDiff
+{
+	GENERATED_BODY()
+
+	// Version of the container the diff brings the caller to
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	int32 Version = 0;
+
+	// True when the journal no longer had every change since the requested version. Changes then holds every stack as added and the caller must drop what it knew.
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	bool bIsFullSnapshot = false;
+
+	// Changes in the order they happened, a stack can appear more than once
+	UPROPERTY(BlueprintReadOnly, Category = TagStack)
+	TArray<FGCTagStackJournalEntry> Changes;
+};
+
 /**
  * Represents one stack of a gameplay tag (tag + count)
  */
@@ -38,11 +161,13 @@ struct GCINVENTORYSYSTEM_API FGCGameplayTagStack : public FFastArraySerializerIt
 
 	float GetStackCount() const;
 
-	FOnStackItemReplicated OnChanged;
+	// Sends the tag through its net index and whole counts as packed integers, other counts are sent as full floats
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
 private:
 
 	friend FGCGameplayTagStackContainer;
+	friend UE::Net::FGCGameplayTagStackNetSerializer;
 
 	UPROPERTY()
 	FGameplayTag Tag;
@@ -51,6 +176,15 @@ private:
 	float StackCount = 0.0f;
 };
 
+template<>
+struct TStructOpsTypeTraits<FGCGameplayTagStack> : public TStructOpsTypeTraitsBase2<FGCGameplayTagStack>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
 /** Container of gameplay tag stacks */
 USTRUCT(BlueprintType)
 struct GCINVENTORYSYSTEM_API FGCGameplayTagStackContainer : public FFastArraySerializer
@@ -73,34 +207,137 @@ public:
 	// Removes all the elements in the stack
 	void ClearStack();
 
+	// Removes and then adds the given stacks, marking every touched stack dirty only once
+	void ApplyStackDelta(const TMap<FGameplayTag, float>& StacksToRemove, const TMap<FGameplayTag, float>& StacksToAdd);
+
 	const TArray<FGCGameplayTagStack>& GetGameplayTagStackList() const;
 
+	// Non-owning view over the stacks, only valid until the container changes
+	TConstArrayView<FGCGameplayTagStack> GetStacksView() const
+	{
+		return Stacks;
+	}
+
+	// Incremented by every local or replicated change of the stacks, cached data built from the stacks is up to date while it does not change
+	int32 GetVersion() const
+	{
+		return Version;
+	}
+
+	// Sum of the counts of every stack, kept up to date by the changes
+	float GetTotalStackCount() const
+	{
+		return static_cast<float>(TotalStackCount);
+	}
+
+	// Keeps the last changes of the stacks in a ring buffer of the given size, 0 disables the journal. Changing the size forgets the journaled changes.
+	void SetJournalCapacity(int32 Capacity);
+
+	// Must be enabled on the containers receiving their stacks through replication, so the running total and the journal know the count a received stack replaces
+	void SetReceivesReplicatedStacks(bool bReceives);
+
+	int32 GetJournalCapacity() const
+	{
+		return Journal.Num();
+	}
+
+	// Returns the changes made after the given version, in O(changes), or every stack when the journal no longer has all of them
+	void GetChangesSince(int32 SinceVersion, FGCTagStackDiff& OutDiff) const;
+
 	// Returns the stack count of the specified tag (or 0 if the tag is not present)
 	float GetStackCount(FGameplayTag Tag) const
 	{
-		return TagToCountMap.FindRef(Tag);
+		const int32 Index = FindStackIndex(Tag);
+		return Index != INDEX_NONE ? Stacks[Index].StackCount : 0.0f;
 	}
 
 	// Returns true if there is at least one stack of the specified tag
 	bool ContainsTag(FGameplayTag Tag) const
 	{
-		return TagToCountMap.Contains(Tag);
+		return FindStackIndex(Tag) != INDEX_NONE;
+	}
+
+	// Number of stacks the container holds before switching from the inline tag scan to the hashed lookup
+	static constexpr int32 InlineStackThreshold = 16;
+
+	// Mirrors the stacks into a dense array indexed by the item ids of the registry, the registry must outlive the container.
+	// Tags without an id are not mirrored, call it again once the registry gave them one.
+	void EnableDenseStorage(const FGCItemIdRegistry* InItemIdRegistry);
+
+	bool IsDenseStorageEnabled() const
+	{
+		return ItemIdRegistry != nullptr;
+	}
+
+	// Returns the stack count of the specified item id (or 0 if the item is not present or dense storage is disabled)
+	float GetStackCountById(int32 ItemId) const
+	{
+		return DenseStacks.GetCount(ItemId);
+	}
+
+	const FGCDenseItemStorage& GetDenseStorage() const
+	{
+		return DenseStacks;
 	}
 
 	//~FFastArraySerializer contract
 	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
 	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
 	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
 	//~End of FFastArraySerializer contract
 
-	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+
+	// Called by FastArrayDeltaSerialize for every stack, leaves out the stacks of a connection's initial sync that are beyond the current chunk
+	template<typename Type, typename SerializerType>
+	bool ShouldWriteFastArrayItem(const Type& Item, const bool bIsWritingOnClient)
+	{
+		if (bWritingInitialSyncChunk && Item.ReplicationID != INDEX_NONE && !InitialSyncChunkIDs.Contains(Item.ReplicationID)
+			&& !(InitialSyncChunkBaseline && InitialSyncChunkBaseline->IDToCWMap.Contains(Item.ReplicationID)))
+		{
+			return false;
+		}
+
+		return FFastArraySerializer::ShouldWriteFastArrayItem<Type, SerializerType>(Item, bIsWritingOnClient);
+	}
+
+	// Limits how many stacks a connection in its initial sync (for example when it joins) receives per net update, 0 sends them all at once
+	void SetInitialSyncChunkSize(int32 ChunkSize)
+	{
+		InitialSyncChunkSize = FMath::Max(ChunkSize, 0);
+	}
+
+	// Orders the stacks sent in chunks, lower priorities are sent first
+	void SetInitialSyncPriority(TFunction<int32(const FGameplayTag&)>&& PriorityFunction)
 	{
-		return FFastArraySerializer::FastArrayDeltaSerialize<FGCGameplayTagStack, FGCGameplayTagStackContainer>(Stacks, DeltaParms, *this);
+		InitialSyncPriority = MoveTemp(PriorityFunction);
+		PrioritizedSlotsVersion = INDEX_NONE;
+	}
+
+	// Returns the tags of the stacks in the order a connection in its initial sync receives them
+	void GetInitialSyncOrder(TArray<FGameplayTag>& OutTags);
+
+	// Returns true if a connection received only a chunk of the stacks since the last call. The owner must keep the property dirty until it returns false.
+	bool ConsumePendingInitialSync()
+	{
+		const bool bPending = bInitialSyncPending;
+		bInitialSyncPending = false;
+		return bPending;
 	}
 
 	FGCGameplayTagStack* GetTagStackItem(const FGameplayTag& tag);
 
-	void BindDelegateToStackReplicated(const FGameplayTag& tag, const FDynamicOnStackItemReplicated& onStackItemReplicated, const UObject* ownerUObject);
+	// Calls the delegate every time the stack of the tag is added, changed or removed, whether the tag is held yet or not
+	FDelegateHandle SubscribeToTag(const FGameplayTag& Tag, FOnStackItemReplicated::FDelegate&& Delegate);
+
+	void UnsubscribeFromTag(const FGameplayTag& Tag, FDelegateHandle Handle);
+
+	// Removes every subscription of the object to the tag
+	void UnsubscribeFromTag(const FGameplayTag& Tag, const void* UserObject);
+
+	// Subscribes the dynamic delegate to the tag for as long as the owner is alive. Subscriptions of owners destroyed since are dropped first.
+	FDelegateHandle BindDelegateToStackReplicated(const FGameplayTag& tag, const FDynamicOnStackItemReplicated& onStackItemReplicated, const UObject* ownerUObject);
 	
 	void BindDelegateToOnTagStackUpdated(FOnTagStackUpdatedDynamicDelegate eventCallbackDelegate);
 
@@ -108,14 +345,183 @@ public:
 
 	FOnTagStackUpdatedDelegate OnTagStackUpdated;
 
+	// Lets the owner push the replicated property dirty, never executed by the replication callbacks
+	FOnTagStackDirty OnTagStackDirty;
+
+	// Broadcast after every local change of the stacks, for the owner's own bookkeeping. Replicated changes are reported by OnStacksReplicated.
+	FOnTagStackChanged OnTagStackChanged;
+
+	// Executed on clients once a replication update has been fully applied
+	FSimpleDelegate OnReplicatedReceive;
+
+	// Broadcasted on clients with every add, change and removal of a replication update (or of every update since the last flush when deferred)
+	FOnTagStacksReplicated OnStacksReplicated;
+
+	// When enabled the replicated changes are kept until FlushReplicatedChanges is called, usually once per frame by the owner
+	void SetDeferReplicatedChanges(bool bDefer)
+	{
+		bDeferReplicatedChanges = bDefer;
+	}
+
+	bool HasPendingReplicatedChanges() const
+	{
+		return PendingReplicatedChanges.Num() > 0;
+	}
+
+	// Broadcasts the pending replicated changes through OnStacksReplicated
+	void FlushReplicatedChanges();
+
 private:
 
+	// Returns the slot of the tag inside Stacks (or INDEX_NONE if the tag is not present)
+	int32 FindStackIndex(const FGameplayTag& Tag) const
+	{
+		if (!bUseTagIndexMap)
+		{
+			return FindInlineStackIndex(Tag);
+		}
+
+		const int32* Index = TagToIndexMap.Find(Tag);
+		checkSlow(!Index || (Stacks.IsValidIndex(*Index) && Stacks[*Index].Tag == Tag));
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	// Scans the packed tag keys four at a time
+	int32 FindInlineStackIndex(const FGameplayTag& Tag) const;
+
+	// Makes the stack at the given slot findable by its tag, switching to the hashed lookup past InlineStackThreshold
+	void RegisterStackIndex(const FGameplayTag& Tag, int32 Index);
+
+	// Makes the stack at the given slot unreachable by lookups while it waits to be removed by the fast array
+	void UnregisterStackIndex(const FGameplayTag& Tag, int32 Index);
+
+	// Rebuilds the lookup of every stack from the current slots
+	void RebuildStackLookup();
+
+	// Removes the stack at the given slot by swapping the last stack into it, keeping the index map in sync
+	void RemoveStackAtSwap(int32 Index);
+
+	void NotifyTagSubscribers(const FGameplayTag& Tag);
+
+	// Queues the replicated change of the tag, merging it with a pending change of the same tag
+	void AddReplicatedChange(const FGameplayTag& Tag, float StackCount, EGCTagStackChangeType ChangeType);
+
+	// Returns true if the connection owning the baseline is in its initial sync: it has no baseline yet, or its baseline was written with a chunk
+	bool IsInitialSyncBaseline(const FNetFastTArrayBaseState* OldState);
+
+	// Picks the next InitialSyncChunkSize stacks missing from the baseline, by priority. Returns false if every missing stack fits in the chunk.
+	bool SelectInitialSyncChunk(const FNetFastTArrayBaseState* OldState);
+
+	// Returns the slots of the stacks sorted by InitialSyncPriority, sorted again only when the stacks changed
+	const TArray<int32>& GetPrioritizedSlots();
+
+	// Moves the running total from the old count of the stack to the new one and records the change in the journal (a count of 0 for a removed stack)
+	void AccountStackChange(const FGameplayTag& Tag, float OldStackCount, float NewStackCount, int32 ChangeVersion);
+
+	// Returns the count the container accounted for the stack before a replication update changed it
+	float GetAccountedStackCount(const FGCGameplayTagStack& Stack) const;
+
+	// Records the change in the journal, overwriting the oldest change once it is full
+	void JournalChange(const FGameplayTag& Tag, float OldStackCount, float NewStackCount, int32 ChangeVersion);
+
+	// Copies the stack count of the tag into the dense storage (a count of 0 removes it)
+	void SyncDenseStack(const FGameplayTag& Tag, float StackCount)
+	{
+		if (ItemIdRegistry)
+		{
+			DenseStacks.SetCount(ItemIdRegistry->FindId(Tag), StackCount);
+		}
+	}
+
 	// Replicated list of gameplay tag stacks
 	UPROPERTY()
 	TArray<FGCGameplayTagStack> Stacks;
 
-	// Accelerated list of tag stacks for queries
-	TMap<FGameplayTag, float> TagToCountMap;
+	// Accelerated lookup from a tag to its slot inside Stacks, only used past InlineStackThreshold stacks
+	TMap<FGameplayTag, int32> TagToIndexMap;
+
+	// Hash of the tag of every slot inside Stacks, used while the container is small
+	TArray<uint32, TInlineAllocator<InlineStackThreshold>> InlineTagKeys;
+
+	// Slots of InlineTagKeys holding a registered stack, cleared for the slots pending a replicated removal.
+	// Any value is a valid tag hash, so the keys themselves cannot mark them.
+	TBitArray<TInlineAllocator<1>> InlineLiveSlots;
+
+	bool bUseTagIndexMap = false;
+
+	int32 Version = 0;
+
+	// Kept as a double so adding and removing counts for a long time does not drift
+	double TotalStackCount = 0.0;
+
+	// Count of every stack as last accounted for, only kept while receiving replicated stacks. The replication callbacks only see the received count,
+	// and the members of an item that are not replicated are not guaranteed to survive an update (Iris may apply received items as copies), so it is kept here.
+	TMap<FGameplayTag, float> AccountedStackCounts;
+
+	bool bReceivesReplicatedStacks = false;
+
+	// Ring buffer of the last changes, empty while the journal is disabled
+	TArray<FGCTagStackJournalEntry> Journal;
+
+	// Slot the next change is written to
+	int32 NextJournalEntry = 0;
+
+	int32 NumJournalEntries = 0;
+
+	// Every change with a greater version is still in the journal
+	int32 JournalStartVersion = 0;
+
+	// Slots removed by the last replication update, used to fix up the index map once the fast array swapped the stacks around
+	TArray<int32> PendingReplicatedRemovals;
+
+	// Registry used to give dense ids to the tags, null while dense storage is disabled
+	const FGCItemIdRegistry* ItemIdRegistry = nullptr;
+
+	// Stack counts indexed by item id, only maintained while dense storage is enabled
+	FGCDenseItemStorage DenseStacks;
+
+	int32 InitialSyncChunkSize = 0;
+
+	TFunction<int32(const FGameplayTag&)> InitialSyncPriority;
+
+	TArray<int32> PrioritizedSlots;
+
+	// Version of the stacks the prioritized slots were sorted for
+	int32 PrioritizedSlotsVersion = INDEX_NONE;
+
+	bool bInitialSyncPending = false;
+
+	// Baselines written with only a chunk of the stacks, the connections holding them are still in their initial sync
+	TArray<TWeakPtr<INetDeltaBaseState>> ChunkedBaselines;
+
+	// Baseline and chunk of the initial sync being written, only set while FastArrayDeltaSerialize runs
+	const FNetFastTArrayBaseState* InitialSyncChunkBaseline = nullptr;
+
+	TSet<int32> InitialSyncChunkIDs;
+
+	bool bWritingInitialSyncChunk = false;
+
+	TArray<FGCTagStackChange> PendingReplicatedChanges;
+
+	// Slot of every tag inside PendingReplicatedChanges
+	TMap<FGameplayTag, int32> PendingReplicatedChangeIndices;
+
+	bool bDeferReplicatedChanges = false;
+
+	// Subscribers of every tag, shared so a broadcast survives the map being modified by the subscribers
+	TMap<FGameplayTag, TSharedRef<FOnStackItemReplicated>> TagSubscriptions;
+
+	// Subscription made by BindDelegateToStackReplicated, kept to drop it once its owner is destroyed
+	struct FDynamicTagSubscription
+	{
+		FGameplayTag Tag;
+
+		FDelegateHandle Handle;
+
+		TWeakObjectPtr<const UObject> Owner;
+	};
+
+	TArray<FDynamicTagSubscription> DynamicTagSubscriptions;
 };
 
 template<>
@@ -0,0 +1,178 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GCGameplayTagStackNetSerializer.h"
+
+#if UE_WITH_IRIS
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GCGameplayTagStackNetSerializer)
+
+#include "GCGameplayTagStack.h"
+#include "GameplayTagsManager.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetBitStreamUtil.h"
+#include "Iris/Serialization/NetSerializerDelegates.h"
+#include "Iris/ReplicationState/PropertyNetSerializerInfoRegistry.h"
+
+namespace UE::Net
+{
+
+struct FGCGameplayTagStackNetSerializer
+{
+	static const uint32 Version = 0;
+
+	struct FQuantizedType
+	{
+		uint32 TagNetIndex;
+
+		// Zigzag encoded whole count, or the bits of the float count
+		uint32 Count;
+
+		uint8 bWholeCount;
+	};
+
+	typedef FGCGameplayTagStack SourceType;
+	typedef FQuantizedType QuantizedType;
+	typedef FGCGameplayTagStackNetSerializerConfig ConfigType;
+
+	static const ConfigType DefaultConfig;
+
+	static void Serialize(FNetSerializationContext&, const FNetSerializeArgs& Args);
+	static void Deserialize(FNetSerializationContext&, const FNetDeserializeArgs& Args);
+
+	static void Quantize(FNetSerializationContext&, const FNetQuantizeArgs& Args);
+	static void Dequantize(FNetSerializationContext&, const FNetDequantizeArgs& Args);
+
+	static bool IsEqual(FNetSerializationContext&, const FNetIsEqualArgs& Args);
+	static bool Validate(FNetSerializationContext&, const FNetValidateArgs& Args);
+
+private:
+
+	class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+	{
+	public:
+		virtual ~FNetSerializerRegistryDelegates();
+
+	private:
+		virtual void OnPreFreezeNetSerializerRegistry() override;
+	};
+
+	static FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+};
+
+UE_NET_IMPLEMENT_SERIALIZER(FGCGameplayTagStackNetSerializer);
+
+const FGCGameplayTagStackNetSerializer::ConfigType FGCGameplayTagStackNetSerializer::DefaultConfig;
+
+FGCGameplayTagStackNetSerializer::FNetSerializerRegistryDelegates FGCGameplayTagStackNetSerializer::NetSerializerRegistryDelegates;
+
+static const FName PropertyNetSerializerRegistry_NAME_GCGameplayTagStack("GCGameplayTagStack");
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_GCGameplayTagStack, FGCGameplayTagStackNetSerializer);
+
+void FGCGameplayTagStackNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	Writer->WriteBits(Value.TagNetIndex, UGameplayTagsManager::Get().GetNetIndexTrueBitNum());
+
+	// same layout as FGCGameplayTagStack::NetSerialize: one bit, then a packed whole count or the full float
+	if (Writer->WriteBool(Value.bWholeCount != 0))
+	{
+		WritePackedUint32(Writer, Value.Count);
+	}
+	else
+	{
+		Writer->WriteBits(Value.Count, 32U);
+	}
+}
+
+void FGCGameplayTagStackNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+{
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+	Target.TagNetIndex = Reader->ReadBits(UGameplayTagsManager::Get().GetNetIndexTrueBitNum());
+	Target.bWholeCount = Reader->ReadBool() ? 1 : 0;
+	Target.Count = Target.bWholeCount ? ReadPackedUint32(Reader) : Reader->ReadBits(32U);
+}
+
+void FGCGameplayTagStackNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	const float StackCount = Source.StackCount;
+
+	Target.TagNetIndex = UGameplayTagsManager::Get().GetNetIndexFromTag(Source.Tag);
+	Target.bWholeCount = GCTagStackSerialization::IsWholeCount(StackCount) ? 1 : 0;
+
+	if (Target.bWholeCount)
+	{
+		Target.Count = GCTagStackSerialization::EncodeWholeCount(StackCount);
+	}
+	else
+	{
+		// copied rather than read through a pointer of another type, which is undefined behavior
+		FMemory::Memcpy(&Target.Count, &StackCount, sizeof(uint32));
+	}
+}
+
+void FGCGameplayTagStackNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+{
+	const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+
+	// only the replicated members are written, the fast array item bookkeeping belongs to the receiving array.
+	// The node of the net index holds its tag, so no name has to be looked up for every received stack.
+	const auto& NetworkTagNodes = UGameplayTagsManager::Get().GetNetworkGameplayTagNodeIndex();
+	const int32 TagNetIndex = static_cast<int32>(Source.TagNetIndex);
+	Target.Tag = NetworkTagNodes.IsValidIndex(TagNetIndex) && NetworkTagNodes[TagNetIndex].IsValid() ? NetworkTagNodes[TagNetIndex]->GetCompleteTag() : FGameplayTag();
+
+	if (Source.bWholeCount)
+	{
+		Target.StackCount = GCTagStackSerialization::DecodeWholeCount(Source.Count);
+	}
+	else
+	{
+		FMemory::Memcpy(&Target.StackCount, &Source.Count, sizeof(float));
+	}
+}
+
+bool FGCGameplayTagStackNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+{
+	if (Args.bStateIsQuantized)
+	{
+		const QuantizedType& Value0 = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+		const QuantizedType& Value1 = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+
+		return Value0.TagNetIndex == Value1.TagNetIndex && Value0.bWholeCount == Value1.bWholeCount && Value0.Count == Value1.Count;
+	}
+
+	const SourceType& Value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+	const SourceType& Value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+
+	return Value0.Tag == Value1.Tag && Value0.StackCount == Value1.StackCount;
+}
+
+bool FGCGameplayTagStackNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	const auto& TagsManager = UGameplayTagsManager::Get();
+
+	return !Source.Tag.IsValid() || TagsManager.GetNetIndexFromTag(Source.Tag) != TagsManager.GetInvalidTagNetIndex();
+}
+
+FGCGameplayTagStackNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+{
+	UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_GCGameplayTagStack);
+}
+
+void FGCGameplayTagStackNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+{
+	UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_GCGameplayTagStack);
+}
+
+}
+
+#endif // UE_WITH_IRIS
@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#if UE_WITH_IRIS
+
+#include "Iris/Serialization/NetSerializer.h"
+
+#include "GCGameplayTagStackNetSerializer.generated.h"
+
+USTRUCT()
+struct FGCGameplayTagStackNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+namespace UE::Net
+{
+
+// Iris counterpart of FGCGameplayTagStack::NetSerialize, so both replication systems put the same packed stacks on the wire.
+// The container itself is replicated by the Iris fast array support, which keeps the PostReplicatedAdd/Change and PreReplicatedRemove callbacks.
+UE_NET_DECLARE_SERIALIZER(FGCGameplayTagStackNetSerializer, GCINVENTORYSYSTEM_API);
+
+}
+
+#endif // UE_WITH_IRIS
@@ -0,0 +1,276 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GCRecipeGraph.h"
+#include "Modules/GCInventorySystem.h"
+#include <Algo/BinarySearch.h>
+
+void FGCRecipeGraph::Build(const FGCCompiledRecipeTable& compiledRecipes)
+{
+	Reset();
+
+	const auto recipes = compiledRecipes.GetRecipes();
+
+	int32 numIngredients = 0;
+
+	for (const auto& recipe : recipes)
+	{
+		numIngredients = FMath::Max(numIngredients, recipe.FirstIngredient + recipe.NumIngredients);
+	}
+
+	IngredientRecipes.Init(INDEX_NONE, numIngredients);
+
+	TArray<int32> numPendingIngredients;
+	numPendingIngredients.SetNumZeroed(recipes.Num());
+
+	// dependents of every recipe, stored per ingredient so a recipe using the same intermediate twice is released once per use
+	TMultiMap<int32, int32> recipeDependents;
+
+	for (int32 recipeIndex = 0; recipeIndex < recipes.Num(); ++recipeIndex)
+	{
+		const auto& recipe = recipes[recipeIndex];
+		const auto ingredients = compiledRecipes.GetIngredients(recipe);
+
+		for (int32 ingredientIndex = 0; ingredientIndex < ingredients.Num(); ++ingredientIndex)
+		{
+			const int32 ingredientRecipe = compiledRecipes.FindRecipeIndex(ingredients[ingredientIndex].ItemTag);
+			IngredientRecipes[recipe.FirstIngredient + ingredientIndex] = ingredientRecipe;
+
+			if (ingredientRecipe != INDEX_NONE)
+			{
+				++numPendingIngredients[recipeIndex];
+				recipeDependents.Add(ingredientRecipe, recipeIndex);
+			}
+		}
+	}
+
+	// Kahn's algorithm, the recipes that never run out of pending ingredients are part of a cycle or depend on one
+	TArray<int32> readyRecipes;
+	TArray<int32> dependents;
+
+	for (int32 recipeIndex = 0; recipeIndex < recipes.Num(); ++recipeIndex)
+	{
+		if (numPendingIngredients[recipeIndex] == 0)
+		{
+			readyRecipes.Add(recipeIndex);
+		}
+	}
+
+	TopologicalRanks.Init(INDEX_NONE, recipes.Num());
+	int32 numOrderedRecipes = 0;
+
+	for (int32 readyIndex = 0; readyIndex < readyRecipes.Num(); ++readyIndex)
+	{
+		const int32 recipeIndex = readyRecipes[readyIndex];
+		TopologicalRanks[recipeIndex] = numOrderedRecipes++;
+
+		dependents.Reset();
+		recipeDependents.MultiFind(recipeIndex, dependents);
+
+		for (const int32 dependentIndex : dependents)
+		{
+			if (--numPendingIngredients[dependentIndex] == 0)
+			{
+				readyRecipes.Add(dependentIndex);
+			}
+		}
+	}
+
+	if (numOrderedRecipes < recipes.Num())
+	{
+		for (int32 recipeIndex = 0; recipeIndex < recipes.Num(); ++recipeIndex)
+		{
+			if (TopologicalRanks[recipeIndex] == INDEX_NONE)
+			{
+				UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Recipe of %s is part of a recipe cycle or depends on one. Its ingredients will not be crafted by crafting plans."), ANSI_TO_TCHAR(__FUNCTION__), *recipes[recipeIndex].ItemTag.ToString());
+			}
+		}
+	}
+}
+
+void FGCRecipeGraph::Reset()
+{
+	IngredientRecipes.Reset();
+	TopologicalRanks.Reset();
+	RecipeClosures.Reset();
+}
+
+TConstArrayView<int32> FGCRecipeGraph::GetRecipeClosure(const FGCCompiledRecipeTable& compiledRecipes, int32 recipeIndex) const
+{
+	// the closures are cached without a lock
+	check(IsInGameThread());
+
+	if (const auto cachedClosure = RecipeClosures.Find(recipeIndex))
+	{
+		return *cachedClosure;
+	}
+
+	TArray<int32>& closure = RecipeClosures.Add(recipeIndex);
+	closure.Add(recipeIndex);
+
+	// recipes out of the topological order are crafted from what is held, their ingredients are never expanded
+	if (IsRecipeOrdered(recipeIndex))
+	{
+		TSet<int32> visitedRecipes;
+		visitedRecipes.Add(recipeIndex);
+
+		// ordered recipes only depend on ordered recipes, so the closure never reaches a cycle
+		for (int32 closureIndex = 0; closureIndex < closure.Num(); ++closureIndex)
+		{
+			const auto& recipe = compiledRecipes.GetRecipes()[closure[closureIndex]];
+
+			for (const int32 ingredientRecipe : GetIngredientRecipes(recipe))
+			{
+				if (ingredientRecipe != INDEX_NONE && !visitedRecipes.Contains(ingredientRecipe))
+				{
+					visitedRecipes.Add(ingredientRecipe);
+					closure.Add(ingredientRecipe);
+				}
+			}
+		}
+
+		closure.Sort([this](int32 a, int32 b)
+			{
+				return TopologicalRanks[a] < TopologicalRanks[b];
+			});
+	}
+
+	return closure;
+}
+
+bool FGCRecipeGraph::BuildCraftingPlan(const FGCCompiledRecipeTable& compiledRecipes, int32 recipeIndex, int32 numCrafts, TFunctionRef<float(const FGameplayTag&)> getItemStack, FGCCraftingPlan& outPlan) const
+{
+	outPlan = FGCCraftingPlan();
+
+	const auto recipes = compiledRecipes.GetRecipes();
+
+	if (!recipes.IsValidIndex(recipeIndex) || numCrafts <= 0)
+	{
+		return false;
+	}
+
+	const auto closure = GetRecipeClosure(compiledRecipes, recipeIndex);
+	const bool bExpandIngredients = IsRecipeOrdered(recipeIndex);
+
+	// amount of every item of the closure needed by the recipes using it, indexed like the closure
+	TArray<float, TInlineAllocator<16>> neededItems;
+	neededItems.SetNumZeroed(closure.Num());
+
+	TArray<int32, TInlineAllocator<16>> closureCrafts;
+	closureCrafts.SetNumZeroed(closure.Num());
+
+	TMap<FGameplayTag, float> neededRawItems;
+
+	// the closure is sorted ingredients first, so walking it backwards settles every item before expanding its ingredients
+	for (int32 closureIndex = closure.Num() - 1; closureIndex >= 0; --closureIndex)
+	{
+		const auto& recipe = recipes[closure[closureIndex]];
+		int32 recipeCrafts = 0;
+
+		if (closureIndex == closure.Num() - 1)
+		{
+			// the requested item is always crafted, even if some is already held
+			recipeCrafts = numCrafts;
+		}
+		else
+		{
+			const float missingAmount = neededItems[closureIndex] - getItemStack(recipe.ItemTag);
+
+			if (missingAmount > 0.f)
+			{
+				if (recipe.CraftedQuantity <= 0.f)
+				{
+					outPlan.MissingItems.FindOrAdd(recipe.ItemTag) += missingAmount;
+					continue;
+				}
+
+				recipeCrafts = FMath::CeilToInt(missingAmount / recipe.CraftedQuantity);
+			}
+		}
+
+		if (recipeCrafts == 0)
+		{
+			continue;
+		}
+
+		closureCrafts[closureIndex] = recipeCrafts;
+
+		const auto ingredients = compiledRecipes.GetIngredients(recipe);
+		const auto ingredientRecipes = GetIngredientRecipes(recipe);
+
+		for (int32 ingredientIndex = 0; ingredientIndex < ingredients.Num(); ++ingredientIndex)
+		{
+			const float ingredientAmount = recipeCrafts * ingredients[ingredientIndex].Amount;
+			const int32 ingredientRecipe = ingredientRecipes[ingredientIndex];
+
+			// the ranks of the closure are sorted, so the ingredient recipe is found by its rank
+			const int32 ingredientClosureIndex = bExpandIngredients && ingredientRecipe != INDEX_NONE
+				? Algo::BinarySearchBy(closure, TopologicalRanks[ingredientRecipe], [this](int32 closureRecipe) { return TopologicalRanks[closureRecipe]; })
+				: INDEX_NONE;
+
+			if (ingredientClosureIndex != INDEX_NONE)
+			{
+				neededItems[ingredientClosureIndex] += ingredientAmount;
+			}
+			else
+			{
+				neededRawItems.FindOrAdd(ingredients[ingredientIndex].ItemTag) += ingredientAmount;
+			}
+		}
+	}
+
+	for (const auto& rawItem : neededRawItems)
+	{
+		const float missingAmount = rawItem.Value - getItemStack(rawItem.Key);
+
+		if (missingAmount > 0.f)
+		{
+			outPlan.MissingItems.FindOrAdd(rawItem.Key) += missingAmount;
+		}
+	}
+
+	// net change of every item, crafted amounts minus consumed amounts
+	TMap<FGameplayTag, float> itemChanges;
+
+	for (int32 closureIndex = 0; closureIndex < closure.Num(); ++closureIndex)
+	{
+		const int32 recipeCrafts = closureCrafts[closureIndex];
+
+		if (recipeCrafts == 0)
+		{
+			continue;
+		}
+
+		const auto& recipe = recipes[closure[closureIndex]];
+
+		FGCCraftingPlanStep& step = outPlan.Steps.AddDefaulted_GetRef();
+		step.ItemTag = recipe.ItemTag;
+		step.NumCrafts = recipeCrafts;
+		step.CraftedAmount = recipeCrafts * recipe.CraftedQuantity;
+
+		itemChanges.FindOrAdd(recipe.ItemTag) += step.CraftedAmount;
+
+		for (const auto& ingredient : compiledRecipes.GetIngredients(recipe))
+		{
+			itemChanges.FindOrAdd(ingredient.ItemTag) -= recipeCrafts * ingredient.Amount;
+		}
+	}
+
+	for (const auto& itemChange : itemChanges)
+	{
+		if (FMath::IsNearlyZero(itemChange.Value))
+		{
+			continue;
+		}
+
+		if (itemChange.Value > 0.f)
+		{
+			outPlan.Delta.ItemsToAdd.Add(itemChange.Key, itemChange.Value);
+		}
+		else
+		{
+			outPlan.Delta.ItemsToRemove.Add(itemChange.Key, -itemChange.Value);
+		}
+	}
+
+	return outPlan.IsValid();
+}
@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Types/InventoryTypes.h"
+
+/**
+ * Dependency graph of the compiled recipes, where a recipe depends on the recipes crafting its ingredients.
+ * Built once after the recipes are compiled. Recipes involved in a cycle (or depending on one) are left out of the
+ * topological order and their ingredients are never crafted by a plan.
+ */
+class GCINVENTORYSYSTEM_API FGCRecipeGraph
+{
+public:
+
+	void Build(const FGCCompiledRecipeTable& compiledRecipes);
+
+	void Reset();
+
+	// Returns true if the recipe could be ordered, false if it is part of a cycle or depends on one
+	bool IsRecipeOrdered(int32 recipeIndex) const
+	{
+		return TopologicalRanks.IsValidIndex(recipeIndex) && TopologicalRanks[recipeIndex] != INDEX_NONE;
+	}
+
+	// Recipes reachable from the recipe through its ingredients, ingredients first and the recipe last. Computed once per recipe
+	// and cached by this const query, so it must only be called from the game thread. The view stays valid until the graph is built again.
+	TConstArrayView<int32> GetRecipeClosure(const FGCCompiledRecipeTable& compiledRecipes, int32 recipeIndex) const;
+
+	// Plans the crafts needed to craft the recipe numCrafts times from the held items. Returns true if the plan can be executed. Game thread only, see GetRecipeClosure.
+	bool BuildCraftingPlan(const FGCCompiledRecipeTable& compiledRecipes, int32 recipeIndex, int32 numCrafts, TFunctionRef<float(const FGameplayTag&)> getItemStack, FGCCraftingPlan& outPlan) const;
+
+private:
+
+	// Recipes crafting the ingredients of the recipe, INDEX_NONE for the ingredients that cannot be crafted
+	TConstArrayView<int32> GetIngredientRecipes(const FGCCompiledRecipe& recipe) const
+	{
+		return TConstArrayView<int32>(IngredientRecipes.GetData() + recipe.FirstIngredient, recipe.NumIngredients);
+	}
+
+	// Recipe crafting every ingredient of the compiled table (indexed like its ingredients), INDEX_NONE for items that cannot be crafted
+	TArray<int32> IngredientRecipes;
+
+	// Position of every recipe in the topological order, INDEX_NONE if the recipe could not be ordered
+	TArray<int32> TopologicalRanks;
+
+	// Closures are only computed for the recipes that are planned, and kept until the graph is built again.
+	// Filled by the const queries without any lock, which is why they are restricted to the game thread.
+	mutable TMap<int32, TArray<int32>> RecipeClosures;
+};
@@ -0,0 +1,171 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GCTimingWheel.h"
+
+FGCTimingWheel::FGCTimingWheel()
+{
+	Reset();
+}
+
+int32 FGCTimingWheel::Schedule(uint64 expireTick, int32 payload)
+{
+	int32 timerIndex = FirstFreeTimer;
+
+	if (timerIndex != INDEX_NONE)
+	{
+		FirstFreeTimer = Timers[timerIndex].Next;
+	}
+	else
+	{
+		timerIndex = Timers.AddDefaulted();
+	}
+
+	FTimer& timer = Timers[timerIndex];
+	// the slot of the current tick was already processed
+	timer.ExpireTick = FMath::Max(expireTick, CurrentTick + 1);
+	timer.Payload = payload;
+
+	Insert(timerIndex);
+	++NumTimers;
+
+	return timerIndex;
+}
+
+void FGCTimingWheel::Cancel(int32 timerIndex)
+{
+	if (!Timers.IsValidIndex(timerIndex) || Timers[timerIndex].Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	Unlink(timerIndex);
+
+	FTimer& timer = Timers[timerIndex];
+	timer.Payload = INDEX_NONE;
+	timer.Next = FirstFreeTimer;
+	FirstFreeTimer = timerIndex;
+	--NumTimers;
+}
+
+void FGCTimingWheel::Advance(uint64 targetTick, TArray<int32>& outExpiredPayloads)
+{
+	while (CurrentTick < targetTick)
+	{
+		++CurrentTick;
+
+		// when the lower bits wrap, the current slot of the level above is spread over the levels below.
+		// Higher levels go first, so what they move into a lower level is spread again in the same tick.
+		int32 numWrappedLevels = 0;
+
+		while (numWrappedLevels < NumLevels - 1 && ((CurrentTick >> (SlotBits * (numWrappedLevels + 1))) << (SlotBits * (numWrappedLevels + 1))) == CurrentTick)
+		{
+			++numWrappedLevels;
+		}
+
+		for (int32 level = numWrappedLevels; level > 0; --level)
+		{
+			Cascade(level);
+		}
+
+		const int32 slot = static_cast<int32>(CurrentTick & (NumSlots - 1));
+		int32 timerIndex = SlotHeads[slot];
+		SlotHeads[slot] = INDEX_NONE;
+
+		while (timerIndex != INDEX_NONE)
+		{
+			FTimer& timer = Timers[timerIndex];
+			const int32 nextTimer = timer.Next;
+
+			outExpiredPayloads.Add(timer.Payload);
+
+			timer.Slot = INDEX_NONE;
+			timer.Payload = INDEX_NONE;
+			timer.Prev = INDEX_NONE;
+			timer.Next = FirstFreeTimer;
+			FirstFreeTimer = timerIndex;
+			--NumTimers;
+
+			timerIndex = nextTimer;
+		}
+	}
+}
+
+void FGCTimingWheel::Reset()
+{
+	Timers.Reset();
+	FirstFreeTimer = INDEX_NONE;
+	NumTimers = 0;
+	CurrentTick = 0;
+
+	for (int32& slotHead : SlotHeads)
+	{
+		slotHead = INDEX_NONE;
+	}
+}
+
+void FGCTimingWheel::Insert(int32 timerIndex)
+{
+	FTimer& timer = Timers[timerIndex];
+	const uint64 ticksLeft = timer.ExpireTick - CurrentTick;
+
+	int32 level = 0;
+
+	while (level < NumLevels - 1 && ticksLeft >= (uint64(1) << (SlotBits * (level + 1))))
+	{
+		++level;
+	}
+
+	// timers beyond the last level wait in its furthest slot and are rescheduled when it comes around
+	const uint64 maxTicksLeft = (uint64(1) << (SlotBits * NumLevels)) - 1;
+	const uint64 slotTick = ticksLeft > maxTicksLeft ? CurrentTick + maxTicksLeft : timer.ExpireTick;
+	const int32 slot = level * NumSlots + static_cast<int32>((slotTick >> (SlotBits * level)) & (NumSlots - 1));
+
+	timer.Slot = slot;
+	timer.Prev = INDEX_NONE;
+	timer.Next = SlotHeads[slot];
+
+	if (timer.Next != INDEX_NONE)
+	{
+		Timers[timer.Next].Prev = timerIndex;
+	}
+
+	SlotHeads[slot] = timerIndex;
+}
+
+void FGCTimingWheel::Unlink(int32 timerIndex)
+{
+	FTimer& timer = Timers[timerIndex];
+
+	if (timer.Prev != INDEX_NONE)
+	{
+		Timers[timer.Prev].Next = timer.Next;
+	}
+	else
+	{
+		SlotHeads[timer.Slot] = timer.Next;
+	}
+
+	if (timer.Next != INDEX_NONE)
+	{
+		Timers[timer.Next].Prev = timer.Prev;
+	}
+
+	timer.Slot = INDEX_NONE;
+	timer.Prev = INDEX_NONE;
+	timer.Next = INDEX_NONE;
+}
+
+void FGCTimingWheel::Cascade(int32 level)
+{
+	const int32 slot = level * NumSlots + static_cast<int32>((CurrentTick >> (SlotBits * level)) & (NumSlots - 1));
+
+	int32 timerIndex = SlotHeads[slot];
+	SlotHeads[slot] = INDEX_NONE;
+
+	while (timerIndex != INDEX_NONE)
+	{
+		const int32 nextTimer = Timers[timerIndex].Next;
+		Insert(timerIndex);
+		timerIndex = nextTimer;
+	}
+}
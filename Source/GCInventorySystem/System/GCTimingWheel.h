@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Hierarchical timing wheel counting time in ticks. Scheduling and cancelling are O(1) and advancing costs
+ * one slot per tick plus the timers that expire or move down a level, no matter how many timers are pending.
+ * Each level has NumSlots slots, every slot of a level spanning the whole lower level. Timers further away than
+ * the last level are parked in it and rescheduled every time it turns.
+ */
+class GCINVENTORYSYSTEM_API FGCTimingWheel
+{
+public:
+
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 NumSlots = 1 << SlotBits;
+	static constexpr int32 NumLevels = 4;
+
+	FGCTimingWheel();
+
+	// Schedules the payload to expire at the tick, or on the next tick if the tick already went by. Returns the timer used to cancel it.
+	int32 Schedule(uint64 expireTick, int32 payload);
+
+	// Cancels a timer that has not expired yet
+	void Cancel(int32 timerIndex);
+
+	// Moves the wheel up to the tick and appends the payloads of the expired timers, in expiration order
+	void Advance(uint64 targetTick, TArray<int32>& outExpiredPayloads);
+
+	void Reset();
+
+	uint64 GetCurrentTick() const
+	{
+		return CurrentTick;
+	}
+
+	int32 Num() const
+	{
+		return NumTimers;
+	}
+
+private:
+
+	struct FTimer
+	{
+		uint64 ExpireTick = 0;
+
+		int32 Payload = INDEX_NONE;
+
+		// Slot of the timer over all the levels, INDEX_NONE while the timer is free
+		int32 Slot = INDEX_NONE;
+
+		int32 Prev = INDEX_NONE;
+
+		// Next timer of the slot, or of the free list
+		int32 Next = INDEX_NONE;
+	};
+
+	// Links the timer into the slot matching its expiration
+	void Insert(int32 timerIndex);
+
+	void Unlink(int32 timerIndex);
+
+	// Takes every timer of the slot out and links each of them again from the current tick
+	void Cascade(int32 level);
+
+	// Timers are pooled and linked by index, so scheduling does not allocate once the pool has grown
+	TArray<FTimer> Timers;
+
+	int32 FirstFreeTimer = INDEX_NONE;
+
+	int32 NumTimers = 0;
+
+	// First timer of every slot, level after level
+	int32 SlotHeads[NumLevels * NumSlots];
+
+	uint64 CurrentTick = 0;
+};
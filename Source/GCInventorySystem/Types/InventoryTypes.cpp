@@ -1,3 +1,126 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
-#include "InventoryTypes.h"
\ No newline at end of file
+#include "InventoryTypes.h"
+#include "Modules/GCInventorySystem.h"
+
+void FGCCompiledRecipeTable::Build(const TMap<FGameplayTag, FItemRecipeInfo>& recipeCategories, const TMap<FGameplayTag, FItemKeyInfo>& itemsInformation, const TSet<FGameplayTag>& onDemandCategories)
+{
+	Reset();
+
+	int32 numRecipes = 0;
+	int32 numIngredients = 0;
+
+	for (const auto& category : recipeCategories)
+	{
+		numRecipes += category.Value.ItemRecipes.Num();
+
+		for (const auto& recipe : category.Value.ItemRecipes)
+		{
+			numIngredients += recipe.Value.RecipeElements.Num();
+		}
+	}
+
+	Reserve(numRecipes, numIngredients);
+
+	for (const auto& category : recipeCategories)
+	{
+		for (const auto& recipe : category.Value.ItemRecipes)
+		{
+			const auto itemInfo = itemsInformation.Find(recipe.Key);
+			const bool bIsCategoryItem = itemInfo ? itemInfo->ItemCategoryTag == category.Key : onDemandCategories.Contains(category.Key) && recipe.Key.MatchesTag(category.Key);
+
+			if (!bIsCategoryItem)
+			{
+				UE_LOG(LogInventorySystem, Warning, TEXT("[%s] Recipe for %s is not stored under the category of the item. It will be ignored."), ANSI_TO_TCHAR(__FUNCTION__), *recipe.Key.ToString());
+				continue;
+			}
+
+			FGCCompiledRecipe& compiledRecipe = Recipes.AddDefaulted_GetRef();
+			compiledRecipe.ItemTag = recipe.Key;
+			compiledRecipe.CraftedQuantity = recipe.Value.CraftedQuantity;
+			compiledRecipe.CraftingTime = recipe.Value.CraftingTime;
+			compiledRecipe.FirstIngredient = Ingredients.Num();
+			compiledRecipe.NumIngredients = recipe.Value.RecipeElements.Num();
+
+			for (const auto& element : recipe.Value.RecipeElements)
+			{
+				Ingredients.Add({ element.Key, element.Value });
+			}
+
+			RecipeIndexMap.Add(recipe.Key, Recipes.Num() - 1);
+			RegisterIngredientUses();
+		}
+	}
+}
+
+void FGCCompiledRecipeTable::Reserve(int32 numRecipes, int32 numIngredients)
+{
+	Recipes.Reserve(numRecipes);
+	Ingredients.Reserve(numIngredients);
+	RecipeIndexMap.Reserve(numRecipes);
+}
+
+void FGCCompiledRecipeTable::AddRecipe(const FGameplayTag& itemTag, float craftedQuantity, TConstArrayView<FGCRecipeIngredient> ingredients, float craftingTime /*= 0.f*/)
+{
+	FGCCompiledRecipe& compiledRecipe = Recipes.AddDefaulted_GetRef();
+	compiledRecipe.ItemTag = itemTag;
+	compiledRecipe.CraftedQuantity = craftedQuantity;
+	compiledRecipe.CraftingTime = craftingTime;
+	compiledRecipe.FirstIngredient = Ingredients.Num();
+
+	// rows listing the same item are merged, so every ingredient of a compiled recipe is unique
+	for (const auto& ingredient : ingredients)
+	{
+		const auto compiledIngredients = MakeArrayView(Ingredients).Slice(compiledRecipe.FirstIngredient, Ingredients.Num() - compiledRecipe.FirstIngredient);
+		const auto existingIngredient = compiledIngredients.FindByPredicate([&ingredient](const FGCRecipeIngredient& compiledIngredient)
+			{
+				return compiledIngredient.ItemTag == ingredient.ItemTag;
+			});
+
+		if (existingIngredient)
+		{
+			existingIngredient->Amount += ingredient.Amount;
+		}
+		else
+		{
+			Ingredients.Add(ingredient);
+		}
+	}
+
+	compiledRecipe.NumIngredients = Ingredients.Num() - compiledRecipe.FirstIngredient;
+
+	RecipeIndexMap.Add(itemTag, Recipes.Num() - 1);
+	RegisterIngredientUses();
+}
+
+void FGCCompiledRecipeTable::AssignItemIds(FGCItemIdRegistry& itemIdRegistry)
+{
+	for (FGCRecipeIngredient& ingredient : Ingredients)
+	{
+		ingredient.ItemId = itemIdRegistry.AddItem(ingredient.ItemTag);
+	}
+}
+
+void FGCCompiledRecipeTable::Reset()
+{
+	Recipes.Reset();
+	Ingredients.Reset();
+	RecipeIndexMap.Reset();
+	IngredientRecipesMap.Reset();
+}
+
+void FGCCompiledRecipeTable::RegisterIngredientUses()
+{
+	const int32 recipeIndex = Recipes.Num() - 1;
+
+	for (const auto& ingredient : GetIngredients(Recipes[recipeIndex]))
+	{
+		// a recipe listing the same ingredient twice is only registered once
+		TArray<int32>& recipeIndices = IngredientRecipesMap.FindOrAdd(ingredient.ItemTag);
+
+		if (recipeIndices.Num() == 0 || recipeIndices.Last() != recipeIndex)
+		{
+			recipeIndices.Add(recipeIndex);
+		}
+	}
+}
@@ -34,6 +34,10 @@ struct FItemRecipeElements
 
 	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly)
 	TMap<FGameplayTag, float> RecipeElements;
+
+	// Seconds a crafting job of the item takes, see UGCActorInventoryComponent::QueueItemCraft. CraftItem is always instantaneous.
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, meta = (ClampMin = 0))
+	float CraftingTime = 0.f;
 };
 
 USTRUCT(BlueprintType)
@@ -47,6 +51,241 @@ struct FItemRecipeInfo
 	TMap<FGameplayTag, FItemRecipeElements> ItemRecipes;
 };
 
+UENUM(BlueprintType)
+enum class EGCItemsDatabaseState : uint8
+{
+	Uninitialized,
+	// The items data asset is being streamed or indexed
+	Loading,
+	// Every query of the inventory subsystem is available
+	Ready,
+	// The items data asset could not be loaded
+	Failed
+};
+
+// Ingredient of a compiled recipe
+struct FGCRecipeIngredient
+{
+	FGameplayTag ItemTag;
+
+	float Amount = 0.f;
+
+	// Dense id of the ingredient, see FGCCompiledRecipeTable::AssignItemIds
+	int32 ItemId = INDEX_NONE;
+};
+
+// Recipe flattened at initialization. Its ingredients are stored contiguously inside the owning FGCCompiledRecipeTable
+struct FGCCompiledRecipe
+{
+	FGameplayTag ItemTag;
+
+	float CraftedQuantity = 1.f;
+
+	float CraftingTime = 0.f;
+
+	int32 FirstIngredient = 0;
+
+	int32 NumIngredients = 0;
+};
+
+/**
+ * Immutable table with all the recipes of the game, built once from the mapping data asset.
+ * Lookups are a single hash probe and ingredients are handed out as views, so querying a recipe never allocates.
+ */
+class GCINVENTORYSYSTEM_API FGCCompiledRecipeTable
+{
+public:
+
+	// Flattens the recipe categories. Only the recipes stored under the category of their item are compiled, same as GetItemRecipe.
+	// Items of on demand categories are not known yet, so their recipes are compiled when the item tag is a child of the category tag.
+	void Build(const TMap<FGameplayTag, FItemRecipeInfo>& recipeCategories, const TMap<FGameplayTag, FItemKeyInfo>& itemsInformation, const TSet<FGameplayTag>& onDemandCategories = TSet<FGameplayTag>());
+
+	void Reset();
+
+	// Reserving up front keeps the recipe pointers handed out stable while recipes are added one by one
+	void Reserve(int32 numRecipes, int32 numIngredients);
+
+	// Ingredients listed more than once are merged into a single ingredient
+	void AddRecipe(const FGameplayTag& itemTag, float craftedQuantity, TConstArrayView<FGCRecipeIngredient> ingredients, float craftingTime = 0.f);
+
+	// Gives every ingredient its dense item id, registering the ingredients the registry does not know yet
+	void AssignItemIds(FGCItemIdRegistry& itemIdRegistry);
+
+	// Returns the recipe of the item or nullptr if the item cannot be crafted
+	const FGCCompiledRecipe* FindRecipe(const FGameplayTag& itemTag) const
+	{
+		const int32* recipeIndex = RecipeIndexMap.Find(itemTag);
+		return recipeIndex ? &Recipes[*recipeIndex] : nullptr;
+	}
+
+	TConstArrayView<FGCRecipeIngredient> GetIngredients(const FGCCompiledRecipe& recipe) const
+	{
+		return TConstArrayView<FGCRecipeIngredient>(Ingredients.GetData() + recipe.FirstIngredient, recipe.NumIngredients);
+	}
+
+	TConstArrayView<FGCCompiledRecipe> GetRecipes() const
+	{
+		return Recipes;
+	}
+
+	// Returns the index of the recipe of the item inside GetRecipes, or INDEX_NONE if the item cannot be crafted
+	int32 FindRecipeIndex(const FGameplayTag& itemTag) const
+	{
+		const int32* recipeIndex = RecipeIndexMap.Find(itemTag);
+		return recipeIndex ? *recipeIndex : INDEX_NONE;
+	}
+
+	// Returns the indices of the recipes that use the item as an ingredient
+	TConstArrayView<int32> GetRecipesUsingIngredient(const FGameplayTag& itemTag) const
+	{
+		const auto recipeIndices = IngredientRecipesMap.Find(itemTag);
+		return recipeIndices ? TConstArrayView<int32>(*recipeIndices) : TConstArrayView<int32>();
+	}
+
+private:
+
+	// Adds the last compiled recipe to the recipes of its ingredients
+	void RegisterIngredientUses();
+
+	TArray<FGCCompiledRecipe> Recipes;
+
+	TArray<FGCRecipeIngredient> Ingredients;
+
+	TMap<FGameplayTag, int32> RecipeIndexMap;
+
+	// Reverse index of the ingredients, so a changed item only re-evaluates the recipes using it
+	TMap<FGameplayTag, TArray<int32>> IngredientRecipesMap;
+};
+
+UENUM(BlueprintType)
+enum class EGCInventoryRemovalType : uint8
+{
+	// The owner is notified through ItemRemoved
+	Removed,
+	// The owner is notified through ItemDropped
+	Dropped
+};
+
+// Item delegate of an inventory, used to queue the delegates of the inventories that defer them
+UENUM(BlueprintType)
+enum class EGCInventoryItemEventType : uint8
+{
+	Granted,
+	Used,
+	Removed
+};
+
+UENUM(BlueprintType)
+enum class EGCInventoryReplicationMode : uint8
+{
+	// Every connection receives the whole inventory
+	AllConnections,
+	// Only the owning connection receives the inventory
+	OwnerOnly,
+	// The owning connection receives the whole inventory, the others only the items matching the public item tags
+	OwnerWithPublicSubset
+};
+
+/**
+ * Set of additions and removals applied to an inventory as a single all or nothing operation.
+ * Removals are validated against the current inventory and applied before the additions.
+ */
+USTRUCT(BlueprintType)
+struct FGCInventoryDelta
+{
+	GENERATED_BODY()
+
+	FGCInventoryDelta() {}
+
+	bool IsEmpty() const
+	{
+		return ItemsToAdd.IsEmpty() && ItemsToRemove.IsEmpty();
+	}
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TMap<FGameplayTag, float> ItemsToAdd;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TMap<FGameplayTag, float> ItemsToRemove;
+
+	// How the owner is notified about the removed items
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	EGCInventoryRemovalType RemovalType = EGCInventoryRemovalType::Removed;
+};
+
+USTRUCT(BlueprintType)
+struct FGCCraftingPlanStep
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	FGameplayTag ItemTag;
+
+	// Times the recipe of the item is crafted
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	int32 NumCrafts = 0;
+
+	// Amount of the item the step crafts in total, NumCrafts times the crafted quantity of the recipe
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	float CraftedAmount = 0.f;
+};
+
+/**
+ * Crafts needed to get an item from the current inventory, crafting first the intermediate ingredients that are missing.
+ * Held items are used before crafting more of them, so only the missing amounts are crafted.
+ */
+USTRUCT(BlueprintType)
+struct FGCCraftingPlan
+{
+	GENERATED_BODY()
+
+	bool IsValid() const
+	{
+		return Steps.Num() > 0 && MissingItems.IsEmpty();
+	}
+
+	// Crafts in execution order, ingredients first. The last step is the requested item.
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	TArray<FGCCraftingPlanStep> Steps;
+
+	// Items that have to be gathered because the inventory does not hold enough of them and they cannot be crafted
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	TMap<FGameplayTag, float> MissingItems;
+
+	// Net change of the inventory once every step is crafted, intermediate items crafted and consumed by the plan cancel out
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	FGCInventoryDelta Delta;
+};
+
+// Timed craft of an inventory. Replicated with its start time and duration so clients follow its progress without further updates.
+USTRUCT(BlueprintType)
+struct FGCCraftingJob
+{
+	GENERATED_BODY()
+
+	bool IsStarted() const
+	{
+		return StartTime >= 0.0;
+	}
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	int32 JobId = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	FGameplayTag ItemTag;
+
+	// Server world time the job started at, negative while it waits for the jobs queued before it
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	double StartTime = -1.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crafting")
+	float Duration = 0.f;
+
+	// Ingredients taken from the inventory when the job was queued, given back as they are if it is cancelled. Only known by the server.
+	UPROPERTY(NotReplicated)
+	TMap<FGameplayTag, float> ReservedItems;
+};
+
 USTRUCT(BlueprintType, Blueprintable)
 struct FTestItemEntry : public FTableRowBase
 {
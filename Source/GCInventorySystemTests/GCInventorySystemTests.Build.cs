@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class GCInventorySystemTests : ModuleRules
+{
+	public GCInventorySystemTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// the serialization tests round trip the stacks through their Iris serializer
+		SetupIrisSupport(Target);
+
+		PrivateIncludePaths.Add(ModuleDirectory);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"GameplayTags",
+				"NetCore",
+				"Json",
+				"GCInventorySystem"
+			}
+			);
+	}
+}
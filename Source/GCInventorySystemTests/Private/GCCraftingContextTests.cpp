@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GCInventoryTestActor.h"
+#include "Components/GCActorInventoryComponent.h"
+#include "Components/GCCraftingContext.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+namespace GCCraftingContextTests
+{
+	// Recipe taking one of each of the first four test items
+	constexpr int32 RecipeWidth = 4;
+
+	void TestItemStacks(FAutomationTestBase& test, const FString& what, const UGCActorInventoryComponent* inventory, TConstArrayView<float> expectedStacks)
+	{
+		const auto& itemTags = GCInventoryTests::GetItemTags();
+
+		for (int32 itemIndex = 0; itemIndex < expectedStacks.Num(); ++itemIndex)
+		{
+			test.TestEqual(FString::Printf(TEXT("%s: stack of item %d"), *what, itemIndex), inventory->GetItemStack(itemTags[itemIndex]), expectedStacks[itemIndex]);
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCCraftingContextDrainOrderTest, "GCInventory.Crafting.ContextDrainOrder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCCraftingContextDrainOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace GCCraftingContextTests;
+
+	FGCInventoryTestWorld testWorld;
+	const auto craftedItemTag = GCInventoryTests::GetCraftedItemTag(RecipeWidth);
+
+	// the crafter only holds half of the ingredients, the chest holds all of them
+	const auto crafter = testWorld.SpawnInventoryActor(RecipeWidth / 2, 1.f)->GetInventoryComponent();
+	const auto chest = testWorld.SpawnInventoryActor(RecipeWidth, 2.f)->GetInventoryComponent();
+
+	const TArray<UGCActorInventoryComponent*> sources = { crafter, chest, crafter };
+	FGCCraftingContext craftingContext(sources);
+	TestEqual(TEXT("Repeated sources are ignored"), craftingContext.GetSources().Num(), 2);
+	TestEqual(TEXT("Stacks are summed across the sources"), craftingContext.GetItemStack(GCInventoryTests::GetItemTags()[0]), 3.f);
+	TestEqual(TEXT("The max craftable amount counts every source"), craftingContext.FindMaxCraftableAmount(craftedItemTag), 2);
+
+	// queries from a const inventory use read-only sources
+	const UGCActorInventoryComponent* constCrafter = crafter;
+	TestEqual(TEXT("Max craftable amount from a const inventory"), constCrafter->FindMaxCraftableAmountFromSources(craftedItemTag, { chest }), 2);
+
+	TestEqual(TEXT("A count of 0 crafts nothing"), craftingContext.CraftItem(craftedItemTag, 0), 0);
+	TestItemStacks(*this, TEXT("Nothing crafted"), chest, { 2.f, 2.f, 2.f, 2.f });
+
+	// the ingredients are taken from the crafter first, the missing ones from the chest
+	TestEqual(TEXT("One craft"), craftingContext.CraftItem(craftedItemTag, 1), 1);
+	TestItemStacks(*this, TEXT("Crafter after one craft"), crafter, { 0.f, 0.f });
+	TestItemStacks(*this, TEXT("Chest after one craft"), chest, { 2.f, 2.f, 1.f, 1.f });
+	TestEqual(TEXT("The crafted item goes to the crafter"), crafter->GetItemStack(craftedItemTag), 1.f);
+	TestEqual(TEXT("The chest gets nothing"), chest->GetItemStack(craftedItemTag), 0.f);
+
+	// asking for more than the sources hold crafts what they allow
+	TestEqual(TEXT("Crafts limited by the ingredients"), craftingContext.CraftItem(craftedItemTag, MAX_int32), 1);
+	TestItemStacks(*this, TEXT("Chest after crafting the rest"), chest, { 1.f, 1.f, 0.f, 0.f });
+	TestEqual(TEXT("Every crafted item is in the crafter"), crafter->GetItemStack(craftedItemTag), 2.f);
+	TestEqual(TEXT("Nothing is left to craft"), craftingContext.CraftItem(craftedItemTag, 1), 0);
+
+	const UGCActorInventoryComponent* constChest = chest;
+
+	FGCCraftingContext readOnlyContext;
+	readOnlyContext.AddReadOnlySource(constChest);
+	TestFalse(TEXT("A context with read-only sources cannot craft"), readOnlyContext.CanCraft());
+
+	AddExpectedError(TEXT("holds read-only sources"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestEqual(TEXT("Read-only sources are not crafted from"), readOnlyContext.CraftItem(GCInventoryTests::GetCraftedItemTag(1), 1), 0);
+	TestEqual(TEXT("The read-only source keeps its items"), chest->GetItemStack(GCInventoryTests::GetItemTags()[0]), 1.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCCraftingContextAllOrNothingTest, "GCInventory.Crafting.ContextAllOrNothing", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCCraftingContextAllOrNothingTest::RunTest(const FString& Parameters)
+{
+	using namespace GCCraftingContextTests;
+
+	FGCInventoryTestWorld testWorld;
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+	const auto craftedItemTag = GCInventoryTests::GetCraftedItemTag(RecipeWidth);
+
+	// an owner without the inventory interface rejects every change, so the crafter cannot take the crafted items
+	const auto plainActor = testWorld.GetWorld()->SpawnActor<AActor>();
+	const auto plainCrafter = NewObject<UGCActorInventoryComponent>(plainActor);
+	plainCrafter->RegisterComponent();
+
+	const auto chest = testWorld.SpawnInventoryActor(RecipeWidth, 1.f)->GetInventoryComponent();
+
+	FGCCraftingContext rejectedContext;
+	rejectedContext.AddSource(plainCrafter);
+	rejectedContext.AddSource(chest);
+	TestEqual(TEXT("The ingredients are there"), rejectedContext.FindMaxCraftableAmount(craftedItemTag), 1);
+	TestEqual(TEXT("A source rejecting its share fails the craft"), rejectedContext.CraftItem(craftedItemTag, 1), 0);
+	TestItemStacks(*this, TEXT("The chest was not drained"), chest, { 1.f, 1.f, 1.f, 1.f });
+
+	// a listener of the crafter empties the chest after the crafter changed, the crafter is given back its share
+	const auto crafterActor = testWorld.SpawnInventoryActor(RecipeWidth / 2, 1.f);
+	const auto crafter = crafterActor->GetInventoryComponent();
+
+	crafterActor->OnItemRemoved = [chest, &itemTags](const FGameplayTag& itemTag, float itemStack)
+		{
+			if (chest->GetItemStack(itemTags[RecipeWidth - 1]) > 0.f)
+			{
+				chest->RemoveItemFromInventory(itemTags[RecipeWidth - 1], chest->GetItemStack(itemTags[RecipeWidth - 1]));
+			}
+		};
+
+	AddExpectedError(TEXT("rolling back the craft"), EAutomationExpectedErrorFlags::Contains, 1);
+
+	FGCCraftingContext craftingContext;
+	craftingContext.AddSource(crafter);
+	craftingContext.AddSource(chest);
+	TestEqual(TEXT("A source changed during the craft fails it"), craftingContext.CraftItem(craftedItemTag, 1), 0);
+	crafterActor->OnItemRemoved = nullptr;
+
+	TestItemStacks(*this, TEXT("The crafter got its share back"), crafter, { 1.f, 1.f });
+	TestEqual(TEXT("The crafted item was taken back"), crafter->GetItemStack(craftedItemTag), 0.f);
+	TestItemStacks(*this, TEXT("The chest only lost what the listener removed"), chest, { 1.f, 1.f, 1.f, 0.f });
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,242 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GCInventoryTestActor.h"
+#include "GCInventoryTestComponent.h"
+#include "Misc/AutomationTest.h"
+#include "Net/UnrealNetwork.h"
+
+namespace GCInventoryComponentTests
+{
+	void TestItemStacks(FAutomationTestBase& test, const FString& what, const UGCActorInventoryComponent* inventory, TConstArrayView<float> expectedStacks)
+	{
+		const auto& itemTags = GCInventoryTests::GetItemTags();
+
+		for (int32 itemIndex = 0; itemIndex < expectedStacks.Num(); ++itemIndex)
+		{
+			test.TestEqual(FString::Printf(TEXT("%s: stack of item %d"), *what, itemIndex), inventory->GetItemStack(itemTags[itemIndex]), expectedStacks[itemIndex]);
+		}
+	}
+
+	const FLifetimeProperty* FindLifetimeProperty(const TArray<FLifetimeProperty>& lifetimeProps, const TCHAR* propertyName)
+	{
+		const auto property = FindFProperty<FProperty>(UGCActorInventoryComponent::StaticClass(), propertyName);
+
+		return property ? lifetimeProps.FindByPredicate([property](const FLifetimeProperty& lifetimeProp)
+			{
+				return lifetimeProp.RepIndex == property->RepIndex;
+			}) : nullptr;
+	}
+
+	struct FExpectedConditions
+	{
+		EGCInventoryReplicationMode ReplicationMode = EGCInventoryReplicationMode::AllConnections;
+
+		ELifetimeCondition HeldItemsCondition = COND_None;
+
+		ELifetimeCondition PublicItemsCondition = COND_None;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCInventoryDeltaAtomicityTest, "GCInventory.Component.DeltaAtomicity", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCInventoryDeltaAtomicityTest::RunTest(const FString& Parameters)
+{
+	using namespace GCInventoryComponentTests;
+
+	FGCInventoryTestWorld testWorld;
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	const auto inventoryActor = testWorld.SpawnInventoryActor(2, 2.f);
+	const auto inventory = inventoryActor->GetTestInventoryComponent();
+	inventory->SetHeldItemsJournalCapacity(16);
+
+	const int32 startVersion = inventory->GetInventoryVersion();
+	const int32 startEvents = inventoryActor->NumInventoryEvents;
+
+	// the second removal cannot be fulfilled, so neither the first one nor the addition are applied
+	FGCInventoryDelta invalidDelta;
+	invalidDelta.ItemsToRemove.Add(itemTags[0], 1.f);
+	invalidDelta.ItemsToRemove.Add(itemTags[1], 3.f);
+	invalidDelta.ItemsToAdd.Add(itemTags[2], 1.f);
+
+	TestFalse(TEXT("A delta removing more than is held is rejected"), inventory->ApplyInventoryDelta(invalidDelta));
+	TestItemStacks(*this, TEXT("Rejected removal"), inventory, { 2.f, 2.f, 0.f });
+
+	FGCInventoryDelta malformedDelta;
+	malformedDelta.ItemsToRemove.Add(itemTags[0], 1.f);
+	malformedDelta.ItemsToAdd.Add(itemTags[2], -1.f);
+
+	TestFalse(TEXT("A delta adding a negative amount is rejected"), inventory->ApplyInventoryDelta(malformedDelta));
+	TestItemStacks(*this, TEXT("Rejected addition"), inventory, { 2.f, 2.f, 0.f });
+
+	TestFalse(TEXT("An empty delta is rejected"), inventory->ApplyInventoryDelta(FGCInventoryDelta()));
+
+	TestEqual(TEXT("Rejected deltas do not change the version"), inventory->GetInventoryVersion(), startVersion);
+	TestEqual(TEXT("Rejected deltas do not notify the owner"), inventoryActor->NumInventoryEvents, startEvents);
+	TestEqual(TEXT("Rejected deltas are not broadcast"), inventory->NumInventoryDeltasApplied, 0);
+
+	FGCInventoryDelta validDelta;
+	validDelta.ItemsToRemove.Add(itemTags[0], 2.f);
+	validDelta.ItemsToRemove.Add(itemTags[1], 1.f);
+	validDelta.ItemsToAdd.Add(itemTags[2], 5.f);
+
+	TestTrue(TEXT("A delta that can be fulfilled is applied"), inventory->ApplyInventoryDelta(validDelta));
+	TestItemStacks(*this, TEXT("Applied delta"), inventory, { 0.f, 1.f, 5.f });
+	TestFalse(TEXT("An emptied item is no longer held"), inventory->IsItemInInventory(itemTags[0]));
+
+	TestEqual(TEXT("The owner is notified of every item of the delta"), inventoryActor->NumInventoryEvents, startEvents + 3);
+	TestEqual(TEXT("The delta is broadcast once"), inventory->NumInventoryDeltasApplied, 1);
+	TestEqual(TEXT("The delta is a single version"), inventory->GetInventoryVersion(), startVersion + 1);
+
+	FGCTagStackDiff diff;
+	inventory->GetInventoryChangesSince(startVersion, diff);
+
+	if (TestEqual(TEXT("Every change of the delta is journaled"), diff.Changes.Num(), 3))
+	{
+		for (const auto& change : diff.Changes)
+		{
+			TestEqual(TEXT("The changes of the delta share its version"), change.Version, startVersion + 1);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCInventoryViewsTest, "GCInventory.Component.InventoryViews", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCInventoryViewsTest::RunTest(const FString& Parameters)
+{
+	FGCInventoryTestWorld testWorld;
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	const auto inventory = testWorld.SpawnInventoryActor(4, 2.f)->GetInventoryComponent();
+
+	const auto& snapshot = inventory->GetAllItemsOnInventory();
+	TestEqual(TEXT("The snapshot holds every item"), snapshot.Num(), 4);
+	TestTrue(TEXT("The snapshot is cached while the inventory does not change"), &inventory->GetAllItemsOnInventory() == &snapshot);
+	TestEqual(TEXT("The view holds every item"), inventory->GetHeldItemsView().Num(), 4);
+	TestEqual(TEXT("Total of the held items"), inventory->GetTotalAmountItems(), 8.f);
+
+	inventory->AddItemToInventory(itemTags[4], 3.f);
+	inventory->RemoveItemFromInventory(itemTags[0], 2.f);
+
+	const auto& changedSnapshot = inventory->GetAllItemsOnInventory();
+	TestEqual(TEXT("The snapshot is rebuilt after a change"), changedSnapshot.Num(), 4);
+	TestEqual(TEXT("The snapshot holds the added item"), changedSnapshot.FindRef(itemTags[4]), 3.f);
+	TestFalse(TEXT("The snapshot drops the removed item"), changedSnapshot.Contains(itemTags[0]));
+	TestEqual(TEXT("The total follows the changes"), inventory->GetTotalAmountItems(), 9.f);
+
+	inventory->ClearInventory();
+
+	TestEqual(TEXT("The snapshot of a cleared inventory is empty"), inventory->GetAllItemsOnInventory().Num(), 0);
+	TestEqual(TEXT("The view of a cleared inventory is empty"), inventory->GetHeldItemsView().Num(), 0);
+	TestEqual(TEXT("The total of a cleared inventory"), inventory->GetTotalAmountItems(), 0.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCInventoryReplicationConditionsTest, "GCInventory.Component.ReplicationConditions", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCInventoryReplicationConditionsTest::RunTest(const FString& Parameters)
+{
+	using namespace GCInventoryComponentTests;
+
+	FGCInventoryTestWorld testWorld;
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+	const FGameplayTagContainer publicItemTags(itemTags[0]);
+
+	const FExpectedConditions expectedConditions[] = {
+		{ EGCInventoryReplicationMode::AllConnections, COND_None, COND_Never },
+		{ EGCInventoryReplicationMode::OwnerOnly, COND_OwnerOnly, COND_Never },
+		{ EGCInventoryReplicationMode::OwnerWithPublicSubset, COND_OwnerOnly, COND_SkipOwner }
+	};
+
+	for (const auto& expected : expectedConditions)
+	{
+		const auto inventory = testWorld.SpawnInventoryActor(0, 1.f)->GetTestInventoryComponent();
+		inventory->SetReplicationMode(expected.ReplicationMode, publicItemTags);
+
+		const FString modeName = StaticEnum<EGCInventoryReplicationMode>()->GetNameStringByValue(static_cast<int64>(expected.ReplicationMode));
+
+		TArray<FLifetimeProperty> lifetimeProps;
+		inventory->GetLifetimeReplicatedProps(lifetimeProps);
+
+		const auto heldItemsProp = FindLifetimeProperty(lifetimeProps, TEXT("HeldItemTags"));
+		const auto publicItemsProp = FindLifetimeProperty(lifetimeProps, TEXT("PublicHeldItemTags"));
+
+		if (!TestTrue(FString::Printf(TEXT("%s: the held and public items are registered"), *modeName), heldItemsProp && publicItemsProp))
+		{
+			continue;
+		}
+
+		TestTrue(FString::Printf(TEXT("%s: condition of the held items"), *modeName), heldItemsProp->Condition == expected.HeldItemsCondition);
+		TestTrue(FString::Printf(TEXT("%s: condition of the public items"), *modeName), publicItemsProp->Condition == expected.PublicItemsCondition);
+		TestTrue(FString::Printf(TEXT("%s: the held items are push based"), *modeName), heldItemsProp->bIsPushBased);
+		TestTrue(FString::Printf(TEXT("%s: the public items are push based"), *modeName), publicItemsProp->bIsPushBased);
+	}
+
+	// the public items follow the held items that match the public tags, and only those
+	const auto inventory = testWorld.SpawnInventoryActor(0, 1.f)->GetTestInventoryComponent();
+	inventory->SetReplicationMode(EGCInventoryReplicationMode::OwnerWithPublicSubset, publicItemTags);
+
+	TestTrue(TEXT("Local changes push the held items dirty"), inventory->GetHeldItems().OnTagStackDirty.IsBound());
+
+	inventory->AddItemToInventory(itemTags[0], 3.f);
+	inventory->AddItemToInventory(itemTags[1], 2.f);
+
+	TestEqual(TEXT("A public item is copied to the public items"), inventory->GetPublicHeldItems().GetStackCount(itemTags[0]), 3.f);
+	TestFalse(TEXT("A private item is not copied to the public items"), inventory->GetPublicHeldItems().ContainsTag(itemTags[1]));
+
+	inventory->RemoveItemFromInventory(itemTags[0], 1.f);
+
+	TestEqual(TEXT("The public items follow the removals"), inventory->GetPublicHeldItems().GetStackCount(itemTags[0]), 2.f);
+	TestEqual(TEXT("Stack of a public item"), inventory->GetPublicItemStack(itemTags[0]), 2.f);
+	TestEqual(TEXT("Private items have no public stack"), inventory->GetPublicItemStack(itemTags[1]), 0.f);
+
+	inventory->RemoveItemFromInventory(itemTags[0], 2.f);
+
+	TestFalse(TEXT("An emptied public item is removed from the public items"), inventory->GetPublicHeldItems().ContainsTag(itemTags[0]));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCInventoryFullySyncedTest, "GCInventory.Component.FullySynced", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCInventoryFullySyncedTest::RunTest(const FString& Parameters)
+{
+	FGCInventoryTestWorld testWorld;
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	TestTrue(TEXT("The server is always fully synced"), testWorld.SpawnInventoryActor(2, 1.f)->GetInventoryComponent()->IsInventoryFullySynced());
+
+	// a client receiving the held items of the server in several updates
+	const auto clientActor = testWorld.SpawnInventoryActor(0, 1.f);
+	clientActor->SetRole(ROLE_SimulatedProxy);
+
+	const auto inventory = clientActor->GetTestInventoryComponent();
+	TestFalse(TEXT("A client starts without the held items"), inventory->IsInventoryFullySynced());
+
+	inventory->ReceiveNumHeldItemStacks(3);
+	inventory->ReceiveHeldItemStack(itemTags[0], 1.f);
+	inventory->ReceiveHeldItemStack(itemTags[1], 1.f);
+
+	TestFalse(TEXT("A client missing held items is not fully synced"), inventory->IsInventoryFullySynced());
+	TestEqual(TEXT("Nothing is broadcast while held items are missing"), inventory->NumInventoryFullySynced, 0);
+
+	inventory->ReceiveHeldItemStack(itemTags[2], 1.f);
+
+	TestTrue(TEXT("A client holding every item is fully synced"), inventory->IsInventoryFullySynced());
+	TestEqual(TEXT("Fully synced is broadcast once every item arrived"), inventory->NumInventoryFullySynced, 1);
+
+	inventory->ReceiveHeldItemStack(itemTags[3], 1.f);
+
+	TestEqual(TEXT("Fully synced is only broadcast once"), inventory->NumInventoryFullySynced, 1);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
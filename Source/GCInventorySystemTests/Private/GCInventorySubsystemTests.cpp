@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Subsystems/GCInventoryGISSubsystems.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCOnDemandCategoryWhileLoadingTest, "GCInventory.Subsystem.OnDemandCategoryWhileLoading", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCOnDemandCategoryWhileLoadingTest::RunTest(const FString& Parameters)
+{
+	FGCInventoryTestWorld testWorld(true);
+	const auto inventorySubsystem = testWorld.GetInventorySubsystem();
+	const auto& onDemandItemTags = GCInventoryTests::GetOnDemandItemTags();
+
+	// the items are handed over by a game thread task, which has not run yet
+	if (!TestTrue(TEXT("The items database loads asynchronously"), inventorySubsystem->GetItemsDatabaseState() == EGCItemsDatabaseState::Loading))
+	{
+		return false;
+	}
+
+	AddExpectedError(TEXT("Could not find the item with the tag"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestFalse(TEXT("On demand items are not loaded while the items database loads"), inventorySubsystem->GetItemKeyInformationFromTag(onDemandItemTags[0]).ItemTag.IsValid());
+
+	bool bCategoryLoaded = false;
+	inventorySubsystem->RequestItemsCategoryLoad(onDemandItemTags[1], FSimpleDelegate::CreateLambda([&bCategoryLoaded]()
+		{
+			bCategoryLoaded = true;
+		}));
+	TestFalse(TEXT("The category request waits for the items database"), bCategoryLoaded);
+
+	if (!TestTrue(TEXT("The items database is ready"), testWorld.WaitForItemsDatabase()))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("The category requested while loading is loaded"), GCInventoryTests::PumpGameThreadUntil([&bCategoryLoaded]() { return bCategoryLoaded; }));
+
+	for (const auto& onDemandItemTag : onDemandItemTags)
+	{
+		TestEqual(FString::Printf(TEXT("%s is found"), *onDemandItemTag.ToString()), inventorySubsystem->GetItemKeyInformationFromTag(onDemandItemTag).ItemTag, onDemandItemTag);
+		TestNotEqual(FString::Printf(TEXT("%s has an item id"), *onDemandItemTag.ToString()), inventorySubsystem->FindItemId(onDemandItemTag), static_cast<int32>(INDEX_NONE));
+	}
+
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+	TestEqual(TEXT("Items of the data asset are found"), inventorySubsystem->GetItemKeyInformationFromTag(itemTags[0]).ItemTag, itemTags[0]);
+	TestEqual(TEXT("Every item has its own id"), inventorySubsystem->GetItemIdRegistry().Num(), itemTags.Num() + static_cast<int32>(UE_ARRAY_COUNT(GCInventoryTests::RecipeWidths)) + onDemandItemTags.Num());
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+#include "Misc/CommandLine.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "GCInventoryTestFixture.h"
+#endif // WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Editor only module holding the automation tests and benchmarks of the inventory system, so the test items
+ * never reach the gameplay tags of games, servers or the databases cooked by the commandlets.
+ */
+class FGCInventorySystemTestsModule : public IModuleInterface
+{
+public:
+
+	virtual void StartupModule() override
+	{
+#if WITH_DEV_AUTOMATION_TESTS
+		// commandlets cook data against the project tags (see GCCookItemDatabase), the test tags would change its net indices
+		if (!IsRunningCommandlet())
+		{
+			GCInventoryTests::RegisterNativeTags();
+		}
+#endif // WITH_DEV_AUTOMATION_TESTS
+	}
+};
+
+IMPLEMENT_MODULE(FGCInventorySystemTestsModule, GCInventorySystemTests)
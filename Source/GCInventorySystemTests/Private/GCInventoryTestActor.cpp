@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestActor.h"
+#include "GCInventoryTestComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GCInventoryTestActor)
+
+AGCInventoryTestActor::AGCInventoryTestActor(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	InventoryComponent = CreateDefaultSubobject<UGCInventoryTestComponent>(TEXT("InventoryComponent"));
+}
+
+void AGCInventoryTestActor::ItemGranted_Implementation(const FGameplayTag& itemTag, float itemStack)
+{
+	++NumInventoryEvents;
+}
+
+void AGCInventoryTestActor::ItemUsed_Implementation(const FGameplayTag& itemTag, float itemStack)
+{
+	++NumInventoryEvents;
+}
+
+void AGCInventoryTestActor::ItemRemoved_Implementation(const FGameplayTag& itemTag, float itemStack)
+{
+	++NumInventoryEvents;
+
+	if (OnItemRemoved)
+	{
+		OnItemRemoved(itemTag, itemStack);
+	}
+}
+
+void AGCInventoryTestActor::ItemDropped_Implementation(const FGameplayTag& itemTag, float itemStack)
+{
+	++NumInventoryEvents;
+}
+
+void AGCInventoryTestActor::ItemCrafted_Implementation(const FGameplayTag& itemTag, const float amount)
+{
+	++NumInventoryEvents;
+}
+
+UGCActorInventoryComponent* AGCInventoryTestActor::GetInventoryComponent() const
+{
+	return InventoryComponent;
+}
+
+UGCInventoryTestComponent* AGCInventoryTestActor::GetTestInventoryComponent() const
+{
+	return InventoryComponent;
+}
+
+void AGCInventoryTestActor::HandleItemUpdated()
+{
+	++NumItemUpdatedEvents;
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "Interfaces/GCInventoryInterface.h"
+
+#include "GCInventoryTestActor.generated.h"
+
+class UGCActorInventoryComponent;
+class UGCInventoryTestComponent;
+
+/**
+ * Inventory owner spawned by the automation tests, implementing the inventory interface natively.
+ */
+UCLASS(NotBlueprintable, NotPlaceable, Transient, HideDropdown)
+class AGCInventoryTestActor : public AActor, public IGCInventoryInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	AGCInventoryTestActor(const FObjectInitializer& ObjectInitializer);
+
+	//~IGCInventoryInterface
+	virtual void ItemGranted_Implementation(const FGameplayTag& itemTag, float itemStack) override;
+	virtual void ItemUsed_Implementation(const FGameplayTag& itemTag, float itemStack) override;
+	virtual void ItemRemoved_Implementation(const FGameplayTag& itemTag, float itemStack) override;
+	virtual void ItemDropped_Implementation(const FGameplayTag& itemTag, float itemStack) override;
+	virtual void ItemCrafted_Implementation(const FGameplayTag& itemTag, const float amount) override;
+	virtual UGCActorInventoryComponent* GetInventoryComponent() const override;
+	//~IGCInventoryInterface
+
+	UGCInventoryTestComponent* GetTestInventoryComponent() const;
+
+	// Bound to the item updates of other inventories by the tests, counts the updates in NumItemUpdatedEvents
+	UFUNCTION()
+	void HandleItemUpdated();
+
+	// Number of interface events received, so the tests can check they were delivered
+	int32 NumInventoryEvents = 0;
+
+	int32 NumItemUpdatedEvents = 0;
+
+	// Called when the owner is told an item was removed, so the tests can change other inventories in the middle of a change
+	TFunction<void(const FGameplayTag& itemTag, float itemStack)> OnItemRemoved;
+
+protected:
+
+	UPROPERTY(VisibleAnywhere, Category = "Inventory")
+	TObjectPtr<UGCInventoryTestComponent> InventoryComponent;
+};
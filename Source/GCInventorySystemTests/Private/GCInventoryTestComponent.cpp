@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GCInventoryTestComponent)
+
+UGCInventoryTestComponent::UGCInventoryTestComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+void UGCInventoryTestComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	OnInventoryDeltaApplied.AddUniqueDynamic(this, &ThisClass::HandleInventoryDeltaApplied);
+	OnInventoryFullySynced.AddUniqueDynamic(this, &ThisClass::HandleInventoryFullySynced);
+}
+
+void UGCInventoryTestComponent::SetReplicationMode(EGCInventoryReplicationMode replicationMode, const FGameplayTagContainer& publicItemTags)
+{
+	ReplicationMode = replicationMode;
+	PublicItemTags = publicItemTags;
+}
+
+void UGCInventoryTestComponent::SetHeldItemsJournalCapacity(int32 journalCapacity)
+{
+	HeldItemsJournalCapacity = journalCapacity;
+	HeldItemTags.SetJournalCapacity(journalCapacity);
+}
+
+void UGCInventoryTestComponent::ReceiveNumHeldItemStacks(int32 numHeldItemStacks)
+{
+	NumHeldItemStacks = numHeldItemStacks;
+	OnRep_NumHeldItemStacks();
+}
+
+void UGCInventoryTestComponent::ReceiveHeldItemStack(const FGameplayTag& itemTag, float itemStack)
+{
+	// replicated stacks are never pushed dirty nor counted as held by the client
+	const FOnTagStackDirty onTagStackDirty = HeldItemTags.OnTagStackDirty;
+	HeldItemTags.OnTagStackDirty.Unbind();
+	HeldItemTags.AddStack(itemTag, itemStack);
+	HeldItemTags.OnTagStackDirty = onTagStackDirty;
+
+	HeldItemTags.OnReplicatedReceive.ExecuteIfBound();
+}
+
+void UGCInventoryTestComponent::HandleInventoryDeltaApplied(const FGCInventoryDelta& delta, AActor* ownerReference)
+{
+	++NumInventoryDeltasApplied;
+}
+
+void UGCInventoryTestComponent::HandleInventoryFullySynced(AActor* ownerReference)
+{
+	++NumInventoryFullySynced;
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/GCActorInventoryComponent.h"
+
+#include "GCInventoryTestComponent.generated.h"
+
+/**
+ * Inventory component of the test actors, exposing the replication settings and callbacks to the automation tests.
+ */
+UCLASS(NotBlueprintable, Transient, HideDropdown)
+class UGCInventoryTestComponent : public UGCActorInventoryComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UGCInventoryTestComponent(const FObjectInitializer& ObjectInitializer);
+
+	// Begin UActorComponent Interface
+	virtual void OnRegister() override;
+	// End UActorComponent Interface
+
+	// Only read when the replicated properties are registered and when the held items change, so it can be changed on a registered component
+	void SetReplicationMode(EGCInventoryReplicationMode replicationMode, const FGameplayTagContainer& publicItemTags);
+
+	void SetHeldItemsJournalCapacity(int32 journalCapacity);
+
+	const FGCGameplayTagStackContainer& GetHeldItems() const
+	{
+		return HeldItemTags;
+	}
+
+	const FGCGameplayTagStackContainer& GetPublicHeldItems() const
+	{
+		return PublicHeldItemTags;
+	}
+
+	// Stands in for the replicated number of held stacks sent by the server
+	void ReceiveNumHeldItemStacks(int32 numHeldItemStacks);
+
+	// Stands in for a replication update holding the stack, which bypasses the local change bookkeeping
+	void ReceiveHeldItemStack(const FGameplayTag& itemTag, float itemStack);
+
+	// Number of OnInventoryDeltaApplied and OnInventoryFullySynced broadcasts, so the tests can check they were sent once
+	int32 NumInventoryDeltasApplied = 0;
+
+	int32 NumInventoryFullySynced = 0;
+
+protected:
+
+	UFUNCTION()
+	void HandleInventoryDeltaApplied(const FGCInventoryDelta& delta, AActor* ownerReference);
+
+	UFUNCTION()
+	void HandleInventoryFullySynced(AActor* ownerReference);
+};
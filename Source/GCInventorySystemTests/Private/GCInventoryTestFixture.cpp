@@ -0,0 +1,311 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GCInventoryTestActor.h"
+#include "Components/GCActorInventoryComponent.h"
+#include "Subsystems/GCInventoryGISSubsystems.h"
+#include "GameplayTagsManager.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Engine/DataTable.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformProcess.h"
+#include "Serialization/JsonWriter.h"
+
+namespace GCInventoryTests
+{
+	const TCHAR* CategoryTagName = TEXT("GCInventory.Test");
+
+	const TCHAR* OnDemandCategoryTagName = TEXT("GCInventory.Test.OnDemand");
+
+	FName MakeItemTagName(int32 itemIndex)
+	{
+		return *FString::Printf(TEXT("%s.Item%03d"), CategoryTagName, itemIndex);
+	}
+
+	FName MakeCraftedItemTagName(int32 recipeWidth)
+	{
+		return *FString::Printf(TEXT("%s.Crafted%02d"), CategoryTagName, recipeWidth);
+	}
+
+	FName MakeOnDemandItemTagName(int32 itemIndex)
+	{
+		return *FString::Printf(TEXT("%s.Item%03d"), OnDemandCategoryTagName, itemIndex);
+	}
+
+	int32 GetNumTestItems()
+	{
+		static const int32 numTestItems = []()
+			{
+				int32 numItems = DefaultNumTestItems;
+				FParse::Value(FCommandLine::Get(), TEXT("GCInventoryTestItems="), numItems);
+				return FMath::Max(numItems, DefaultNumTestItems);
+			}();
+
+		return numTestItems;
+	}
+
+	void RegisterNativeTags()
+	{
+		UGameplayTagsManager::OnLastChanceToAddNativeTags().AddLambda([]()
+			{
+				auto& tagsManager = UGameplayTagsManager::Get();
+				tagsManager.AddNativeGameplayTag(CategoryTagName, TEXT("Items of the inventory automation tests"));
+
+				for (int32 itemIndex = 0; itemIndex < GetNumTestItems(); ++itemIndex)
+				{
+					tagsManager.AddNativeGameplayTag(MakeItemTagName(itemIndex));
+				}
+
+				for (const int32 recipeWidth : RecipeWidths)
+				{
+					tagsManager.AddNativeGameplayTag(MakeCraftedItemTagName(recipeWidth));
+				}
+
+				tagsManager.AddNativeGameplayTag(OnDemandCategoryTagName, TEXT("On demand category of the inventory automation tests"));
+
+				for (int32 itemIndex = 0; itemIndex < NumOnDemandTestItems; ++itemIndex)
+				{
+					tagsManager.AddNativeGameplayTag(MakeOnDemandItemTagName(itemIndex));
+				}
+			});
+	}
+
+	FGameplayTag GetCategoryTag()
+	{
+		return FGameplayTag::RequestGameplayTag(CategoryTagName);
+	}
+
+	const TArray<FGameplayTag>& GetItemTags()
+	{
+		static TArray<FGameplayTag> itemTags;
+
+		if (itemTags.Num() == 0)
+		{
+			itemTags.Reserve(GetNumTestItems());
+
+			for (int32 itemIndex = 0; itemIndex < GetNumTestItems(); ++itemIndex)
+			{
+				itemTags.Add(FGameplayTag::RequestGameplayTag(MakeItemTagName(itemIndex)));
+			}
+		}
+
+		return itemTags;
+	}
+
+	FGameplayTag GetCraftedItemTag(int32 recipeWidth)
+	{
+		return FGameplayTag::RequestGameplayTag(MakeCraftedItemTagName(recipeWidth));
+	}
+
+	FGameplayTag GetOnDemandCategoryTag()
+	{
+		return FGameplayTag::RequestGameplayTag(OnDemandCategoryTagName);
+	}
+
+	const TArray<FGameplayTag>& GetOnDemandItemTags()
+	{
+		static TArray<FGameplayTag> onDemandItemTags;
+
+		if (onDemandItemTags.Num() == 0)
+		{
+			for (int32 itemIndex = 0; itemIndex < NumOnDemandTestItems; ++itemIndex)
+			{
+				onDemandItemTags.Add(FGameplayTag::RequestGameplayTag(MakeOnDemandItemTagName(itemIndex)));
+			}
+		}
+
+		return onDemandItemTags;
+	}
+
+	bool PumpGameThreadUntil(TFunctionRef<bool()> condition, double timeoutSeconds /*= 10.0*/)
+	{
+		const double endSeconds = FPlatformTime::Seconds() + timeoutSeconds;
+
+		// streaming callbacks and the tasks sent back to the game thread only run when it processes them
+		while (!condition())
+		{
+			if (FPlatformTime::Seconds() > endSeconds)
+			{
+				return false;
+			}
+
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FTSTicker::GetCoreTicker().Tick(0.f);
+			FPlatformProcess::Sleep(0.001f);
+		}
+
+		return true;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// FGCBenchmarkReport
+
+void FGCBenchmarkReport::AddSample(const FGCBenchmarkSample& sample)
+{
+	Samples.Add(sample);
+}
+
+bool FGCBenchmarkReport::Write(FAutomationTestBase& test) const
+{
+	FString csvReport = TEXT("Operation,Variant,InventorySize,RecipeWidth,NumOps,NanosecondsPerOp,BytesPerOp\n");
+
+	FString jsonReport;
+	const auto jsonWriter = TJsonWriterFactory<>::Create(&jsonReport);
+	jsonWriter->WriteArrayStart();
+
+	for (const auto& sample : Samples)
+	{
+		test.AddInfo(FString::Printf(TEXT("%s %s: %d items, recipe width %d, %.1f ns/op"), *sample.Operation, *sample.Variant, sample.InventorySize, sample.RecipeWidth, sample.NanosecondsPerOp)
+			+ (sample.BytesPerOp >= 0.0 ? FString::Printf(TEXT(", %.1f bytes/op"), sample.BytesPerOp) : FString()));
+
+		csvReport += FString::Printf(TEXT("%s,%s,%d,%d,%d,%.3f,%.3f\n"), *sample.Operation, *sample.Variant, sample.InventorySize, sample.RecipeWidth, sample.NumOps, sample.NanosecondsPerOp, sample.BytesPerOp);
+
+		jsonWriter->WriteObjectStart();
+		jsonWriter->WriteValue(TEXT("Operation"), sample.Operation);
+		jsonWriter->WriteValue(TEXT("Variant"), sample.Variant);
+		jsonWriter->WriteValue(TEXT("InventorySize"), sample.InventorySize);
+		jsonWriter->WriteValue(TEXT("RecipeWidth"), sample.RecipeWidth);
+		jsonWriter->WriteValue(TEXT("NumOps"), sample.NumOps);
+		jsonWriter->WriteValue(TEXT("NanosecondsPerOp"), sample.NanosecondsPerOp);
+		jsonWriter->WriteValue(TEXT("BytesPerOp"), sample.BytesPerOp);
+		jsonWriter->WriteObjectEnd();
+	}
+
+	jsonWriter->WriteArrayEnd();
+	jsonWriter->Close();
+
+	const FString reportPath = FPaths::Combine(FPaths::AutomationDir(), TEXT("GCInventory"), Name);
+
+	if (!FFileHelper::SaveStringToFile(csvReport, *(reportPath + TEXT(".csv"))) || !FFileHelper::SaveStringToFile(jsonReport, *(reportPath + TEXT(".json"))))
+	{
+		test.AddError(FString::Printf(TEXT("Failed to write the benchmark report %s"), *reportPath));
+		return false;
+	}
+
+	test.AddInfo(FString::Printf(TEXT("Benchmark report written to %s.csv and %s.json"), *reportPath, *reportPath));
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// FGCInventoryTestWorld
+
+FGCInventoryTestWorld::FGCInventoryTestWorld(bool bInitializeItemsAsynchronously /*= false*/)
+{
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	// rows only need their name, which is the tag of the item
+	ItemsTable.Reset(NewObject<UDataTable>(GetTransientPackage(), NAME_None, RF_Transient));
+	ItemsTable->RowStruct = FTableRowBase::StaticStruct();
+
+	for (const auto& itemTag : itemTags)
+	{
+		ItemsTable->AddRow(itemTag.GetTagName(), FTableRowBase());
+	}
+
+	OnDemandItemsTable.Reset(NewObject<UDataTable>(GetTransientPackage(), NAME_None, RF_Transient));
+	OnDemandItemsTable->RowStruct = FTableRowBase::StaticStruct();
+
+	for (const auto& onDemandItemTag : GCInventoryTests::GetOnDemandItemTags())
+	{
+		OnDemandItemsTable->AddRow(onDemandItemTag.GetTagName(), FTableRowBase());
+	}
+
+	ItemsDataAsset.Reset(NewObject<UGCInventoryMappingDataAsset>(GetTransientPackage(), NAME_None, RF_Transient));
+	ItemsDataAsset->ItemsCategoryMap.Add(GCInventoryTests::GetCategoryTag(), ItemsTable.Get());
+	ItemsDataAsset->OnDemandItemsCategoryMap.Add(GCInventoryTests::GetOnDemandCategoryTag(), TSoftObjectPtr<UDataTable>(OnDemandItemsTable.Get()));
+
+	FItemRecipeInfo& categoryRecipes = ItemsDataAsset->ItemsCategoryCraftingRecipes.Add(GCInventoryTests::GetCategoryTag());
+
+	for (const int32 recipeWidth : GCInventoryTests::RecipeWidths)
+	{
+		const FGameplayTag craftedItemTag = GCInventoryTests::GetCraftedItemTag(recipeWidth);
+		ItemsTable->AddRow(craftedItemTag.GetTagName(), FTableRowBase());
+
+		FItemRecipeElements& recipe = categoryRecipes.ItemRecipes.Add(craftedItemTag);
+
+		for (int32 ingredientIndex = 0; ingredientIndex < recipeWidth; ++ingredientIndex)
+		{
+			recipe.RecipeElements.Add(itemTags[ingredientIndex], 1.f);
+		}
+	}
+
+	// the subsystem copies its settings from the class defaults when the game instance creates it
+	const auto inventorySettings = GetMutableDefault<UGCInventoryGISSubsystems>();
+	const auto previousItemsDataAsset = inventorySettings->ItemsDataAsset;
+	const bool bPreviousUseCookedItemDatabase = inventorySettings->bUseCookedItemDatabase;
+	const bool bPreviousInitializeItemsAsynchronously = inventorySettings->bInitializeItemsAsynchronously;
+
+	inventorySettings->ItemsDataAsset = ItemsDataAsset.Get();
+	inventorySettings->bUseCookedItemDatabase = false;
+	inventorySettings->bInitializeItemsAsynchronously = bInitializeItemsAsynchronously;
+
+	GameInstance.Reset(NewObject<UGameInstance>(GEngine));
+	GameInstance->InitializeStandalone();
+
+	inventorySettings->ItemsDataAsset = previousItemsDataAsset;
+	inventorySettings->bUseCookedItemDatabase = bPreviousUseCookedItemDatabase;
+	inventorySettings->bInitializeItemsAsynchronously = bPreviousInitializeItemsAsynchronously;
+}
+
+FGCInventoryTestWorld::~FGCInventoryTestWorld()
+{
+	// the game instance forgets its world context when it shuts down
+	const auto world = GetWorld();
+
+	GameInstance->Shutdown();
+
+	if (world)
+	{
+		GEngine->DestroyWorldContext(world);
+		world->DestroyWorld(false);
+	}
+}
+
+UWorld* FGCInventoryTestWorld::GetWorld() const
+{
+	return GameInstance->GetWorld();
+}
+
+UGCInventoryGISSubsystems* FGCInventoryTestWorld::GetInventorySubsystem() const
+{
+	return UGameInstance::GetSubsystem<UGCInventoryGISSubsystems>(GameInstance.Get());
+}
+
+AGCInventoryTestActor* FGCInventoryTestWorld::SpawnInventoryActor(int32 inventorySize, float itemStack) const
+{
+	const auto inventoryActor = GetWorld()->SpawnActor<AGCInventoryTestActor>();
+	const auto inventoryComponent = inventoryActor->GetInventoryComponent();
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	for (int32 itemIndex = 0; itemIndex < inventorySize; ++itemIndex)
+	{
+		inventoryComponent->AddItemToInventory(itemTags[itemIndex], itemStack);
+	}
+
+	return inventoryActor;
+}
+
+bool FGCInventoryTestWorld::WaitForItemsDatabase(double timeoutSeconds /*= 10.0*/) const
+{
+	const auto inventorySubsystem = GetInventorySubsystem();
+
+	GCInventoryTests::PumpGameThreadUntil([inventorySubsystem]()
+		{
+			return inventorySubsystem->GetItemsDatabaseState() != EGCItemsDatabaseState::Loading;
+		}, timeoutSeconds);
+
+	return inventorySubsystem->IsItemsDatabaseReady();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
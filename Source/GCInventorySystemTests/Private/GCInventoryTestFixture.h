@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GameplayTagContainer.h"
+#include "HAL/PlatformTime.h"
+#include "Templates/Function.h"
+#include "UObject/StrongObjectPtr.h"
+
+class AGCInventoryTestActor;
+class FAutomationTestBase;
+class UDataTable;
+class UGameInstance;
+class UGCInventoryGISSubsystems;
+class UGCInventoryMappingDataAsset;
+class UWorld;
+
+namespace GCInventoryTests
+{
+	// Items registered for the tests by default, as many as the biggest inventory of the sweeps
+	constexpr int32 DefaultNumTestItems = 512;
+
+	// Items of the on demand category of the test data asset
+	constexpr int32 NumOnDemandTestItems = 4;
+
+	// Inventory sizes and recipe widths swept by the benchmarks
+	constexpr int32 InventorySizes[] = { 8, 64, 512 };
+	constexpr int32 RecipeWidths[] = { 1, 4, 16 };
+
+	// Adds the gameplay tags of the test items to the native tags, must be called before the tags manager is done adding them
+	void RegisterNativeTags();
+
+	// Category of every test item and recipe
+	FGameplayTag GetCategoryTag();
+
+	// Number of registered test items, raised with -GCInventoryTestItems=<N> on the command line for the sweeps over big inventories
+	int32 GetNumTestItems();
+
+	// Returns the test items, a recipe of width N uses the first N of them
+	const TArray<FGameplayTag>& GetItemTags();
+
+	// Returns the item crafted by the recipe taking one of each of the first recipeWidth items
+	FGameplayTag GetCraftedItemTag(int32 recipeWidth);
+
+	// On demand category of the test data asset, its items are children of it
+	FGameplayTag GetOnDemandCategoryTag();
+
+	const TArray<FGameplayTag>& GetOnDemandItemTags();
+
+	// Runs the game thread tasks and tickers until the condition is met. Returns false if it was not met within the timeout.
+	bool PumpGameThreadUntil(TFunctionRef<bool()> condition, double timeoutSeconds = 10.0);
+
+	// Times numOps calls of the operation, numRuns times, and returns the fastest run in nanoseconds per call
+	template <typename OperationType>
+	double MeasureNanosecondsPerOp(int32 numRuns, int32 numOps, OperationType&& operation)
+	{
+		double bestNanoseconds = TNumericLimits<double>::Max();
+
+		for (int32 run = 0; run < numRuns; ++run)
+		{
+			const uint64 startCycles = FPlatformTime::Cycles64();
+
+			for (int32 op = 0; op < numOps; ++op)
+			{
+				operation(op);
+			}
+
+			const double runNanoseconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - startCycles) * 1.0e9;
+			bestNanoseconds = FMath::Min(bestNanoseconds, runNanoseconds / numOps);
+		}
+
+		return bestNanoseconds;
+	}
+}
+
+// Measurement of one benchmark case
+struct FGCBenchmarkSample
+{
+	FString Operation;
+
+	// Implementation or mode measured, empty when the operation has a single one
+	FString Variant;
+
+	int32 InventorySize = 0;
+
+	int32 RecipeWidth = 0;
+
+	int32 NumOps = 0;
+
+	double NanosecondsPerOp = 0.0;
+
+	// Bytes written per operation by the serialization benchmarks, negative for the others
+	double BytesPerOp = -1.0;
+};
+
+/**
+ * Samples of a benchmark test, written as CSV and JSON to <Saved>/Automation/GCInventory/<Name>.csv|json
+ * so runs can be compared across changes.
+ */
+class FGCBenchmarkReport
+{
+public:
+
+	explicit FGCBenchmarkReport(const FString& name) : Name(name) {}
+
+	void AddSample(const FGCBenchmarkSample& sample);
+
+	// Logs the samples to the test and writes the report files. Returns false if a file could not be written.
+	bool Write(FAutomationTestBase& test) const;
+
+private:
+
+	FString Name;
+
+	TArray<FGCBenchmarkSample> Samples;
+};
+
+/**
+ * Game instance whose inventory subsystem is initialized from generated test items and recipes.
+ * The items data asset of the plugin settings is only swapped while the subsystem initializes.
+ */
+class FGCInventoryTestWorld
+{
+public:
+
+	explicit FGCInventoryTestWorld(bool bInitializeItemsAsynchronously = false);
+	~FGCInventoryTestWorld();
+
+	UWorld* GetWorld() const;
+
+	UGCInventoryGISSubsystems* GetInventorySubsystem() const;
+
+	// Spawns an inventory owner holding the first inventorySize test items, itemStack of each
+	AGCInventoryTestActor* SpawnInventoryActor(int32 inventorySize, float itemStack) const;
+
+	// Waits for the asynchronous initialization of the inventory subsystem. Returns true if its items database is ready.
+	bool WaitForItemsDatabase(double timeoutSeconds = 10.0) const;
+
+private:
+
+	TStrongObjectPtr<UDataTable> ItemsTable;
+
+	TStrongObjectPtr<UDataTable> OnDemandItemsTable;
+
+	TStrongObjectPtr<UGCInventoryMappingDataAsset> ItemsDataAsset;
+
+	TStrongObjectPtr<UGameInstance> GameInstance;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "System/GCRecipeGraph.h"
+#include "Misc/AutomationTest.h"
+
+namespace GCRecipeGraphTests
+{
+	/**
+	 * Recipes over the test items: logs make planks, planks make sticks, and a chest takes planks and sticks, so planks are
+	 * an intermediate shared by two recipes. Two more items craft each other in a loop, and a third one is crafted from the loop.
+	 */
+	struct FTestRecipes
+	{
+		FTestRecipes()
+		{
+			const auto& itemTags = GCInventoryTests::GetItemTags();
+			Log = itemTags[0];
+			Plank = itemTags[1];
+			Stick = itemTags[2];
+			Chest = itemTags[3];
+			LoopA = itemTags[4];
+			LoopB = itemTags[5];
+			FromLoop = itemTags[6];
+
+			CompiledRecipes.AddRecipe(Chest, 1.f, { { Plank, 8.f }, { Stick, 2.f } });
+			CompiledRecipes.AddRecipe(Stick, 4.f, { { Plank, 2.f } });
+			CompiledRecipes.AddRecipe(Plank, 4.f, { { Log, 1.f } });
+			CompiledRecipes.AddRecipe(LoopA, 1.f, { { LoopB, 1.f } });
+			CompiledRecipes.AddRecipe(LoopB, 1.f, { { LoopA, 1.f } });
+			CompiledRecipes.AddRecipe(FromLoop, 1.f, { { LoopA, 1.f }, { Log, 1.f } });
+
+			RecipeGraph.Build(CompiledRecipes);
+		}
+
+		bool Plan(const FGameplayTag& itemTag, int32 numCrafts, const TMap<FGameplayTag, float>& heldItems, FGCCraftingPlan& outPlan) const
+		{
+			return RecipeGraph.BuildCraftingPlan(CompiledRecipes, CompiledRecipes.FindRecipeIndex(itemTag), numCrafts, [&heldItems](const FGameplayTag& heldItemTag)
+				{
+					return heldItems.FindRef(heldItemTag);
+				}, outPlan);
+		}
+
+		FGameplayTag Log;
+		FGameplayTag Plank;
+		FGameplayTag Stick;
+		FGameplayTag Chest;
+		FGameplayTag LoopA;
+		FGameplayTag LoopB;
+		FGameplayTag FromLoop;
+
+		FGCCompiledRecipeTable CompiledRecipes;
+
+		FGCRecipeGraph RecipeGraph;
+	};
+
+	struct FExpectedStep
+	{
+		FGameplayTag ItemTag;
+
+		int32 NumCrafts = 0;
+	};
+
+	void TestSteps(FAutomationTestBase& test, const FString& what, const FGCCraftingPlan& plan, TConstArrayView<FExpectedStep> expectedSteps)
+	{
+		if (!test.TestEqual(FString::Printf(TEXT("%s: number of steps"), *what), plan.Steps.Num(), expectedSteps.Num()))
+		{
+			return;
+		}
+
+		for (int32 stepIndex = 0; stepIndex < expectedSteps.Num(); ++stepIndex)
+		{
+			test.TestEqual(FString::Printf(TEXT("%s: item of step %d"), *what, stepIndex), plan.Steps[stepIndex].ItemTag, expectedSteps[stepIndex].ItemTag);
+			test.TestEqual(FString::Printf(TEXT("%s: crafts of step %d"), *what, stepIndex), plan.Steps[stepIndex].NumCrafts, expectedSteps[stepIndex].NumCrafts);
+		}
+	}
+
+	void TestItems(FAutomationTestBase& test, const FString& what, const TMap<FGameplayTag, float>& items, const TMap<FGameplayTag, float>& expectedItems)
+	{
+		test.TestEqual(FString::Printf(TEXT("%s: number of items"), *what), items.Num(), expectedItems.Num());
+
+		for (const auto& expectedItem : expectedItems)
+		{
+			test.TestEqual(FString::Printf(TEXT("%s: amount of %s"), *what, *expectedItem.Key.ToString()), items.FindRef(expectedItem.Key), expectedItem.Value);
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCRecipeGraphOrderTest, "GCInventory.Crafting.RecipeGraphOrder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCRecipeGraphOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace GCRecipeGraphTests;
+
+	// the three recipes of the loop are reported when the graph is built
+	AddExpectedError(TEXT("is part of a recipe cycle"), EAutomationExpectedErrorFlags::Contains, 3);
+
+	const FTestRecipes testRecipes;
+	const auto& compiledRecipes = testRecipes.CompiledRecipes;
+	const auto& recipeGraph = testRecipes.RecipeGraph;
+
+	TestTrue(TEXT("The chest recipe is ordered"), recipeGraph.IsRecipeOrdered(compiledRecipes.FindRecipeIndex(testRecipes.Chest)));
+	TestFalse(TEXT("Recipes of a loop are not ordered"), recipeGraph.IsRecipeOrdered(compiledRecipes.FindRecipeIndex(testRecipes.LoopA)));
+	TestFalse(TEXT("Recipes of a loop are not ordered"), recipeGraph.IsRecipeOrdered(compiledRecipes.FindRecipeIndex(testRecipes.LoopB)));
+	TestFalse(TEXT("Recipes depending on a loop are not ordered"), recipeGraph.IsRecipeOrdered(compiledRecipes.FindRecipeIndex(testRecipes.FromLoop)));
+
+	// the chest was added first, so its closure is only in order if it was sorted by the topological ranks
+	const auto chestClosure = recipeGraph.GetRecipeClosure(compiledRecipes, compiledRecipes.FindRecipeIndex(testRecipes.Chest));
+	if (TestEqual(TEXT("The closure of the chest holds the planks, the sticks and the chest"), chestClosure.Num(), 3))
+	{
+		TestEqual(TEXT("Planks come first"), compiledRecipes.GetRecipes()[chestClosure[0]].ItemTag, testRecipes.Plank);
+		TestEqual(TEXT("Sticks come after the planks"), compiledRecipes.GetRecipes()[chestClosure[1]].ItemTag, testRecipes.Stick);
+		TestEqual(TEXT("The chest comes last"), compiledRecipes.GetRecipes()[chestClosure[2]].ItemTag, testRecipes.Chest);
+	}
+
+	const auto loopClosure = recipeGraph.GetRecipeClosure(compiledRecipes, compiledRecipes.FindRecipeIndex(testRecipes.FromLoop));
+	TestEqual(TEXT("The ingredients of a recipe depending on a loop are not expanded"), loopClosure.Num(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCCraftingPlanTest, "GCInventory.Crafting.CraftingPlan", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCCraftingPlanTest::RunTest(const FString& Parameters)
+{
+	using namespace GCRecipeGraphTests;
+
+	AddExpectedError(TEXT("is part of a recipe cycle"), EAutomationExpectedErrorFlags::Contains, 3);
+
+	const FTestRecipes testRecipes;
+	FGCCraftingPlan plan;
+
+	// the planks needed by the sticks are added to the ones of the chest before the planks are crafted
+	{
+		const TMap<FGameplayTag, float> heldItems = { { testRecipes.Log, 10.f } };
+		TestTrue(TEXT("Shared intermediate: the plan can be crafted"), testRecipes.Plan(testRecipes.Chest, 1, heldItems, plan));
+		TestSteps(*this, TEXT("Shared intermediate"), plan, { { testRecipes.Plank, 3 }, { testRecipes.Stick, 1 }, { testRecipes.Chest, 1 } });
+		TestItems(*this, TEXT("Shared intermediate: missing items"), plan.MissingItems, {});
+		TestItems(*this, TEXT("Shared intermediate: added items"), plan.Delta.ItemsToAdd, { { testRecipes.Chest, 1.f }, { testRecipes.Plank, 2.f }, { testRecipes.Stick, 2.f } });
+		TestItems(*this, TEXT("Shared intermediate: removed items"), plan.Delta.ItemsToRemove, { { testRecipes.Log, 3.f } });
+	}
+
+	// held intermediates are used before crafting more of them
+	{
+		const TMap<FGameplayTag, float> heldItems = { { testRecipes.Log, 10.f }, { testRecipes.Plank, 6.f }, { testRecipes.Stick, 2.f } };
+		TestTrue(TEXT("Held intermediates: the plan can be crafted"), testRecipes.Plan(testRecipes.Chest, 1, heldItems, plan));
+		TestSteps(*this, TEXT("Held intermediates"), plan, { { testRecipes.Plank, 1 }, { testRecipes.Chest, 1 } });
+		TestItems(*this, TEXT("Held intermediates: added items"), plan.Delta.ItemsToAdd, { { testRecipes.Chest, 1.f } });
+		TestItems(*this, TEXT("Held intermediates: removed items"), plan.Delta.ItemsToRemove, { { testRecipes.Log, 1.f }, { testRecipes.Plank, 4.f }, { testRecipes.Stick, 2.f } });
+	}
+
+	// the requested item is crafted even when some of it is held, and as many times as asked
+	{
+		const TMap<FGameplayTag, float> heldItems = { { testRecipes.Log, 10.f }, { testRecipes.Stick, 5.f } };
+		TestTrue(TEXT("Several crafts: the plan can be crafted"), testRecipes.Plan(testRecipes.Stick, 3, heldItems, plan));
+		TestSteps(*this, TEXT("Several crafts"), plan, { { testRecipes.Plank, 2 }, { testRecipes.Stick, 3 } });
+		TestItems(*this, TEXT("Several crafts: added items"), plan.Delta.ItemsToAdd, { { testRecipes.Stick, 12.f }, { testRecipes.Plank, 2.f } });
+		TestItems(*this, TEXT("Several crafts: removed items"), plan.Delta.ItemsToRemove, { { testRecipes.Log, 2.f } });
+	}
+
+	// raw items are netted against the held ones, only what is short is reported
+	{
+		const TMap<FGameplayTag, float> heldItems = { { testRecipes.Log, 1.f } };
+		TestFalse(TEXT("Missing raw items: the plan cannot be crafted"), testRecipes.Plan(testRecipes.Chest, 1, heldItems, plan));
+		TestFalse(TEXT("Missing raw items: the plan is not valid"), plan.IsValid());
+		TestItems(*this, TEXT("Missing raw items"), plan.MissingItems, { { testRecipes.Log, 2.f } });
+	}
+
+	// ingredients coming from a loop are never crafted, only taken from the held items
+	{
+		const TMap<FGameplayTag, float> heldItems = { { testRecipes.Log, 1.f }, { testRecipes.LoopB, 5.f } };
+		TestFalse(TEXT("Loop: the plan cannot be crafted"), testRecipes.Plan(testRecipes.FromLoop, 1, heldItems, plan));
+		TestItems(*this, TEXT("Loop: missing items"), plan.MissingItems, { { testRecipes.LoopA, 1.f } });
+
+		const TMap<FGameplayTag, float> heldLoopItems = { { testRecipes.Log, 1.f }, { testRecipes.LoopA, 1.f } };
+		TestTrue(TEXT("Loop: the plan can be crafted from held items"), testRecipes.Plan(testRecipes.FromLoop, 1, heldLoopItems, plan));
+		TestSteps(*this, TEXT("Loop"), plan, { { testRecipes.FromLoop, 1 } });
+		TestItems(*this, TEXT("Loop: removed items"), plan.Delta.ItemsToRemove, { { testRecipes.Log, 1.f }, { testRecipes.LoopA, 1.f } });
+	}
+
+	TestFalse(TEXT("No crafts cannot be planned"), testRecipes.Plan(testRecipes.Chest, 0, {}, plan));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "System/GCGameplayTagStack.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTagStackInitialSyncOrderTest, "GCInventory.TagStacks.InitialSyncOrder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCTagStackInitialSyncOrderTest::RunTest(const FString& Parameters)
+{
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	FGCGameplayTagStackContainer heldItems;
+	heldItems.SetInitialSyncChunkSize(2);
+
+	for (int32 itemIndex = 0; itemIndex < 6; ++itemIndex)
+	{
+		heldItems.AddStack(itemTags[itemIndex], 1.f);
+	}
+
+	TArray<FGameplayTag> syncOrder;
+	heldItems.GetInitialSyncOrder(syncOrder);
+	TestEqual(TEXT("Without priorities the stacks are sent in slot order"), syncOrder, TArray<FGameplayTag>({ itemTags[0], itemTags[1], itemTags[2], itemTags[3], itemTags[4], itemTags[5] }));
+
+	// the fourth item is sent first, then the sixth one, then the others in slot order
+	heldItems.SetInitialSyncPriority([&itemTags](const FGameplayTag& itemTag)
+		{
+			return itemTag == itemTags[3] ? 0 : itemTag == itemTags[5] ? 1 : 2;
+		});
+
+	heldItems.GetInitialSyncOrder(syncOrder);
+	TestEqual(TEXT("The stacks are sent by priority"), syncOrder, TArray<FGameplayTag>({ itemTags[3], itemTags[5], itemTags[0], itemTags[1], itemTags[2], itemTags[4] }));
+
+	// the removal moves the last stack into the slot of the fourth item, and the new stack takes the last slot
+	heldItems.RemoveStack(itemTags[3], 1.f);
+	heldItems.AddStack(itemTags[6], 1.f);
+
+	heldItems.GetInitialSyncOrder(syncOrder);
+	TestEqual(TEXT("The order follows the changes of the stacks"), syncOrder, TArray<FGameplayTag>({ itemTags[5], itemTags[0], itemTags[1], itemTags[2], itemTags[4], itemTags[6] }));
+
+	TestFalse(TEXT("Nothing is pending until a connection received a chunk"), heldItems.ConsumePendingInitialSync());
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "System/GCGameplayTagStack.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTagStackReplicatedJournalTest, "GCInventory.Serialization.TagStackReplicatedJournal", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCTagStackReplicatedJournalTest::RunTest(const FString& Parameters)
+{
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+	const FGameplayTag itemTag = itemTags[0];
+
+	FGCGameplayTagStackContainer container;
+	container.SetJournalCapacity(16);
+	container.SetReceivesReplicatedStacks(true);
+
+	container.AddStack(itemTag, 5.f);
+	const int32 sinceVersion = container.GetVersion();
+
+	const int32 stackIndex = container.GetStacksView().IndexOfByPredicate([&itemTag](const FGCGameplayTagStack& stack) { return stack.GetGameplayTag() == itemTag; });
+	if (!TestNotEqual(TEXT("The added stack is held"), stackIndex, static_cast<int32>(INDEX_NONE)))
+	{
+		return false;
+	}
+
+	TArray<int32> changedIndices = { stackIndex };
+
+	// a received update may be applied as a newly dequantized item, which keeps nothing of the stack it replaces but the replicated members
+	*container.GetTagStackItem(itemTag) = FGCGameplayTagStack(itemTag, 9.f);
+	container.PostReplicatedChange(changedIndices, container.GetStacksView().Num());
+
+	FGCTagStackDiff diff;
+	container.GetChangesSince(sinceVersion, diff);
+
+	TestFalse(TEXT("The replicated change is diffed from the journal"), diff.bIsFullSnapshot);
+
+	if (TestEqual(TEXT("The replicated change is journaled"), diff.Changes.Num(), 1))
+	{
+		TestEqual(TEXT("The journal holds the count the update replaced"), diff.Changes[0].OldStackCount, 5.f);
+		TestEqual(TEXT("The journal holds the received count"), diff.Changes[0].NewStackCount, 9.f);
+	}
+
+	TestEqual(TEXT("The running total follows the replicated change"), container.GetTotalStackCount(), 9.f);
+
+	const int32 changedVersion = container.GetVersion();
+
+	*container.GetTagStackItem(itemTag) = FGCGameplayTagStack(itemTag, 0.f);
+	container.PreReplicatedRemove(changedIndices, 0);
+
+	container.GetChangesSince(changedVersion, diff);
+
+	TestFalse(TEXT("The replicated removal is diffed from the journal"), diff.bIsFullSnapshot);
+
+	if (TestEqual(TEXT("The replicated removal is journaled"), diff.Changes.Num(), 1))
+	{
+		TestEqual(TEXT("The removal replaces the last received count"), diff.Changes[0].OldStackCount, 9.f);
+		TestEqual(TEXT("The removed stack has no count"), diff.Changes[0].NewStackCount, 0.f);
+	}
+
+	TestEqual(TEXT("The running total drops the removed stack"), container.GetTotalStackCount(), 0.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTagStackJournalWrapTest, "GCInventory.Serialization.TagStackJournalWrap", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCTagStackJournalWrapTest::RunTest(const FString& Parameters)
+{
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	FGCGameplayTagStackContainer container;
+	container.SetJournalCapacity(4);
+
+	container.AddStack(itemTags[0], 1.f);
+	container.AddStack(itemTags[1], 1.f);
+	const int32 sinceVersion = container.GetVersion();
+
+	container.AddStack(itemTags[0], 2.f);
+	container.RemoveStack(itemTags[1], 1.f);
+
+	FGCTagStackDiff diff;
+	container.GetChangesSince(sinceVersion, diff);
+
+	TestFalse(TEXT("The changes fit in the journal"), diff.bIsFullSnapshot);
+	TestEqual(TEXT("The diff brings the caller to the current version"), diff.Version, container.GetVersion());
+
+	if (TestEqual(TEXT("Every change is journaled"), diff.Changes.Num(), 2))
+	{
+		TestEqual(TEXT("The changes are in order"), diff.Changes[0].Tag, itemTags[0]);
+		TestEqual(TEXT("Count before the change"), diff.Changes[0].OldStackCount, 1.f);
+		TestEqual(TEXT("Count after the change"), diff.Changes[0].NewStackCount, 3.f);
+		TestEqual(TEXT("The removal comes last"), diff.Changes[1].Tag, itemTags[1]);
+		TestEqual(TEXT("The removed stack has no count"), diff.Changes[1].NewStackCount, 0.f);
+	}
+
+	// more changes than the journal holds since the caller looked
+	for (int32 itemIndex = 2; itemIndex < 6; ++itemIndex)
+	{
+		container.AddStack(itemTags[itemIndex], 1.f);
+	}
+
+	container.GetChangesSince(sinceVersion, diff);
+
+	TestTrue(TEXT("A caller behind the journal gets a full snapshot"), diff.bIsFullSnapshot);
+
+	if (TestEqual(TEXT("The snapshot holds every stack"), diff.Changes.Num(), 5))
+	{
+		TestEqual(TEXT("The snapshot holds the current counts"), diff.Changes[0].NewStackCount, 3.f);
+	}
+
+	container.GetChangesSince(container.GetVersion(), diff);
+
+	TestFalse(TEXT("An up to date caller does not get a snapshot"), diff.bIsFullSnapshot);
+	TestEqual(TEXT("An up to date caller gets no change"), diff.Changes.Num(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
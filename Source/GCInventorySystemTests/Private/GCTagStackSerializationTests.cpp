@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "System/GCGameplayTagStack.h"
+#include "Engine/NetSerialization.h"
+#include "Misc/AutomationTest.h"
+
+#if UE_WITH_IRIS
+#include "System/GCGameplayTagStackNetSerializer.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetSerializationContext.h"
+#endif // UE_WITH_IRIS
+
+namespace GCTagStackSerializationTests
+{
+	// Whole counts of every packed size, negative ones, and counts that must fall back to the full float
+	constexpr float StackCounts[] = { 0.f, 1.f, 63.f, 64.f, 100000.f, 16777216.f, -1.f, -5000.f, 0.5f, -3.25f, 1.0e10f, -1.0e10f };
+
+	FGCGameplayTagStack RoundTripLegacy(FGCGameplayTagStack stack)
+	{
+		bool bOutSuccess = false;
+
+		FNetBitWriter writer(nullptr, 256);
+		stack.NetSerialize(writer, nullptr, bOutSuccess);
+
+		FNetBitReader reader(nullptr, writer.GetData(), writer.GetNumBits());
+		FGCGameplayTagStack receivedStack;
+		receivedStack.NetSerialize(reader, nullptr, bOutSuccess);
+
+		return receivedStack;
+	}
+
+#if UE_WITH_IRIS
+	// Quantizes, writes, reads and dequantizes the stack the way the Iris replication system does
+	bool RoundTripIris(const FGCGameplayTagStack& stack, FGCGameplayTagStack& outReceivedStack)
+	{
+		using namespace UE::Net;
+
+		const FNetSerializer& serializer = UE_NET_GET_SERIALIZER(FGCGameplayTagStackNetSerializer);
+
+		alignas(16) uint8 quantizedStack[64] = {};
+		alignas(16) uint8 receivedQuantizedStack[64] = {};
+		alignas(16) uint8 bitStreamBuffer[64] = {};
+
+		if (serializer.QuantizedTypeSize > sizeof(quantizedStack))
+		{
+			return false;
+		}
+
+		FNetSerializationContext quantizeContext;
+
+		FNetQuantizeArgs quantizeArgs = {};
+		quantizeArgs.Version = serializer.Version;
+		quantizeArgs.NetSerializerConfig = serializer.DefaultConfig;
+		quantizeArgs.Source = NetSerializerValuePointer(&stack);
+		quantizeArgs.Target = NetSerializerValuePointer(quantizedStack);
+		serializer.Quantize(quantizeContext, quantizeArgs);
+
+		FNetBitStreamWriter writer;
+		writer.InitBytes(bitStreamBuffer, sizeof(bitStreamBuffer));
+		FNetSerializationContext writeContext(&writer);
+
+		FNetSerializeArgs serializeArgs = {};
+		serializeArgs.Version = serializer.Version;
+		serializeArgs.NetSerializerConfig = serializer.DefaultConfig;
+		serializeArgs.Source = NetSerializerValuePointer(quantizedStack);
+		serializer.Serialize(writeContext, serializeArgs);
+		writer.CommitWrites();
+
+		FNetBitStreamReader reader;
+		reader.InitBits(bitStreamBuffer, writer.GetPosBits());
+		FNetSerializationContext readContext(&reader);
+
+		FNetDeserializeArgs deserializeArgs = {};
+		deserializeArgs.Version = serializer.Version;
+		deserializeArgs.NetSerializerConfig = serializer.DefaultConfig;
+		deserializeArgs.Target = NetSerializerValuePointer(receivedQuantizedStack);
+		serializer.Deserialize(readContext, deserializeArgs);
+
+		FNetDequantizeArgs dequantizeArgs = {};
+		dequantizeArgs.Version = serializer.Version;
+		dequantizeArgs.NetSerializerConfig = serializer.DefaultConfig;
+		dequantizeArgs.Source = NetSerializerValuePointer(receivedQuantizedStack);
+		dequantizeArgs.Target = NetSerializerValuePointer(&outReceivedStack);
+		serializer.Dequantize(readContext, dequantizeArgs);
+
+		return !writer.IsOverflown() && !reader.IsOverflown() && !readContext.HasError();
+	}
+#endif // UE_WITH_IRIS
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTagStackRoundTripTest, "GCInventory.Serialization.TagStackRoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCTagStackRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace GCTagStackSerializationTests;
+
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	for (int32 countIndex = 0; countIndex < UE_ARRAY_COUNT(StackCounts); ++countIndex)
+	{
+		const FGCGameplayTagStack stack(itemTags[countIndex % itemTags.Num()], StackCounts[countIndex]);
+		const FString stackDescription = FString::Printf(TEXT("%s x %f"), *stack.GetGameplayTag().ToString(), stack.GetStackCount());
+
+		const auto legacyStack = RoundTripLegacy(stack);
+		TestEqual(FString::Printf(TEXT("Legacy tag of %s"), *stackDescription), legacyStack.GetGameplayTag(), stack.GetGameplayTag());
+		TestEqual(FString::Printf(TEXT("Legacy count of %s"), *stackDescription), legacyStack.GetStackCount(), stack.GetStackCount());
+
+#if UE_WITH_IRIS
+		FGCGameplayTagStack irisStack;
+		if (!TestTrue(FString::Printf(TEXT("Iris round trip of %s"), *stackDescription), RoundTripIris(stack, irisStack)))
+		{
+			continue;
+		}
+
+		TestEqual(FString::Printf(TEXT("Iris tag of %s"), *stackDescription), irisStack.GetGameplayTag(), legacyStack.GetGameplayTag());
+		TestEqual(FString::Printf(TEXT("Iris count of %s"), *stackDescription), irisStack.GetStackCount(), legacyStack.GetStackCount());
+#endif // UE_WITH_IRIS
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GCInventoryTestActor.h"
+#include "Components/GCActorInventoryComponent.h"
+#include "System/GCGameplayTagStack.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTagStackSubscriptionsTest, "GCInventory.TagStacks.Subscriptions", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCTagStackSubscriptionsTest::RunTest(const FString& Parameters)
+{
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	FGCGameplayTagStackContainer heldItems;
+	int32 numFirstItemUpdates = 0;
+	int32 numSecondItemUpdates = 0;
+
+	// subscriptions are made before the items are held
+	const FDelegateHandle firstItemHandle = heldItems.SubscribeToTag(itemTags[0], FOnStackItemReplicated::FDelegate::CreateLambda([&numFirstItemUpdates]()
+		{
+			++numFirstItemUpdates;
+		}));
+
+	heldItems.SubscribeToTag(itemTags[1], FOnStackItemReplicated::FDelegate::CreateLambda([&numSecondItemUpdates]()
+		{
+			++numSecondItemUpdates;
+		}));
+
+	heldItems.AddStack(itemTags[0], 2.f);
+	heldItems.AddStack(itemTags[0], 1.f);
+	heldItems.RemoveStack(itemTags[0], 3.f);
+	heldItems.AddStack(itemTags[2], 1.f);
+
+	TestEqual(TEXT("Every add, change and removal of the item is notified"), numFirstItemUpdates, 3);
+	TestEqual(TEXT("Changes of other items are not notified"), numSecondItemUpdates, 0);
+
+	heldItems.ApplyStackDelta({}, { { itemTags[0], 1.f }, { itemTags[1], 1.f } });
+
+	TestEqual(TEXT("A delta notifies its first item once"), numFirstItemUpdates, 4);
+	TestEqual(TEXT("A delta notifies its second item once"), numSecondItemUpdates, 1);
+
+	heldItems.UnsubscribeFromTag(itemTags[0], firstItemHandle);
+	heldItems.AddStack(itemTags[0], 1.f);
+
+	TestEqual(TEXT("An unsubscribed handle is not notified"), numFirstItemUpdates, 4);
+
+	// a subscriber removing itself while it is notified
+	FDelegateHandle selfRemovingHandle;
+	int32 numSelfRemovingUpdates = 0;
+
+	selfRemovingHandle = heldItems.SubscribeToTag(itemTags[3], FOnStackItemReplicated::FDelegate::CreateLambda([&heldItems, &itemTags, &selfRemovingHandle, &numSelfRemovingUpdates]()
+		{
+			++numSelfRemovingUpdates;
+			heldItems.UnsubscribeFromTag(itemTags[3], selfRemovingHandle);
+		}));
+
+	heldItems.AddStack(itemTags[3], 1.f);
+	heldItems.AddStack(itemTags[3], 1.f);
+
+	TestEqual(TEXT("A subscriber can unsubscribe while it is notified"), numSelfRemovingUpdates, 1);
+
+	heldItems.ClearStack();
+
+	TestEqual(TEXT("Clearing the stacks notifies the held items"), numSecondItemUpdates, 2);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCItemUpdatedEventsTest, "GCInventory.TagStacks.ItemUpdatedEvents", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCItemUpdatedEventsTest::RunTest(const FString& Parameters)
+{
+	FGCInventoryTestWorld testWorld;
+	const auto& itemTags = GCInventoryTests::GetItemTags();
+
+	const auto inventory = testWorld.SpawnInventoryActor(0, 1.f)->GetInventoryComponent();
+	const auto listener = testWorld.SpawnInventoryActor(0, 1.f);
+	const auto destroyedListener = testWorld.SpawnInventoryActor(0, 1.f);
+
+	FDynamicOnStackItemReplicated onItemUpdated;
+	onItemUpdated.BindUFunction(listener, GET_FUNCTION_NAME_CHECKED(AGCInventoryTestActor, HandleItemUpdated));
+
+	FDynamicOnStackItemReplicated onDestroyedItemUpdated;
+	onDestroyedItemUpdated.BindUFunction(destroyedListener, GET_FUNCTION_NAME_CHECKED(AGCInventoryTestActor, HandleItemUpdated));
+
+	auto eventHandle = inventory->BindEventToItemUpdated(itemTags[0], listener, onItemUpdated);
+	inventory->BindEventToItemUpdated(itemTags[0], destroyedListener, onDestroyedItemUpdated);
+	TestTrue(TEXT("Binding returns a valid handle"), eventHandle.IsValid());
+
+	inventory->AddItemToInventory(itemTags[0], 1.f);
+	inventory->AddItemToInventory(itemTags[1], 1.f);
+
+	TestEqual(TEXT("The listener is notified of its item"), listener->NumItemUpdatedEvents, 1);
+	TestEqual(TEXT("Every listener of the item is notified"), destroyedListener->NumItemUpdatedEvents, 1);
+
+	// the events of a destroyed owner are dropped without being unbound
+	destroyedListener->Destroy();
+	inventory->AddItemToInventory(itemTags[0], 1.f);
+
+	TestEqual(TEXT("The listener is still notified"), listener->NumItemUpdatedEvents, 2);
+	TestEqual(TEXT("A destroyed listener is not notified"), destroyedListener->NumItemUpdatedEvents, 1);
+
+	inventory->UnbindItemUpdatedEvent(eventHandle);
+	TestFalse(TEXT("Unbinding invalidates the handle"), eventHandle.IsValid());
+
+	inventory->AddItemToInventory(itemTags[0], 1.f);
+	TestEqual(TEXT("An unbound event is not notified"), listener->NumItemUpdatedEvents, 2);
+
+	inventory->BindEventToItemUpdated(itemTags[0], listener, onItemUpdated);
+	inventory->BindEventToItemUpdated(itemTags[0], listener, onItemUpdated);
+	inventory->RemoveItemFromInventory(itemTags[0], 1.f);
+
+	TestEqual(TEXT("Every bound event is notified"), listener->NumItemUpdatedEvents, 4);
+
+	inventory->UnbindEventFromItemUpdated(itemTags[0], listener);
+	inventory->RemoveItemFromInventory(itemTags[0], 1.f);
+
+	TestEqual(TEXT("Unbinding the owner removes all of its events"), listener->NumItemUpdatedEvents, 4);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
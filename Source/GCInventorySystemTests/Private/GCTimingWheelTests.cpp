@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GCInventoryTestFixture.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "System/GCTimingWheel.h"
+#include "Misc/AutomationTest.h"
+
+namespace GCTimingWheelTests
+{
+	constexpr uint64 LevelSpan1 = uint64(1) << FGCTimingWheel::SlotBits;
+	constexpr uint64 LevelSpan2 = uint64(1) << (FGCTimingWheel::SlotBits * 2);
+	constexpr uint64 LevelSpan3 = uint64(1) << (FGCTimingWheel::SlotBits * 3);
+	constexpr uint64 WheelSpan = uint64(1) << (FGCTimingWheel::SlotBits * FGCTimingWheel::NumLevels);
+
+	// Delays on both sides of every level boundary, and beyond the last level where timers are parked and rescheduled
+	constexpr uint64 BoundaryDelays[] = { 1, 2, LevelSpan1 - 1, LevelSpan1, LevelSpan1 + 1, LevelSpan2 - 1, LevelSpan2, LevelSpan2 + 1,
+		LevelSpan3 - 1, LevelSpan3, LevelSpan3 + 1, WheelSpan - 1, WheelSpan, WheelSpan + 1, WheelSpan * 2 + LevelSpan2 + 3 };
+
+	// Advances the wheel right before and then up to the tick, so the payload is known to expire at that exact tick
+	bool ExpiresAt(FAutomationTestBase& test, FGCTimingWheel& timingWheel, uint64 expireTick, int32 payload)
+	{
+		TArray<int32> expiredPayloads;
+
+		timingWheel.Advance(expireTick - 1, expiredPayloads);
+		if (!test.TestEqual(FString::Printf(TEXT("Nothing expires before tick %llu"), expireTick), expiredPayloads.Num(), 0))
+		{
+			return false;
+		}
+
+		timingWheel.Advance(expireTick, expiredPayloads);
+		return test.TestEqual(FString::Printf(TEXT("Expired timers at tick %llu"), expireTick), expiredPayloads.Num(), 1)
+			&& test.TestEqual(FString::Printf(TEXT("Payload expired at tick %llu"), expireTick), expiredPayloads[0], payload);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTimingWheelBoundariesTest, "GCInventory.TimingWheel.LevelBoundaries", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCTimingWheelBoundariesTest::RunTest(const FString& Parameters)
+{
+	using namespace GCTimingWheelTests;
+
+	// aligned and unaligned starts, the slot of a level depends on the low bits of the current tick
+	for (const uint64 startTick : { uint64(0), uint64(37), LevelSpan2 - 1, LevelSpan3 + LevelSpan1 + 5 })
+	{
+		FGCTimingWheel timingWheel;
+		TArray<int32> expiredPayloads;
+		timingWheel.Advance(startTick, expiredPayloads);
+
+		for (int32 delayIndex = 0; delayIndex < UE_ARRAY_COUNT(BoundaryDelays); ++delayIndex)
+		{
+			timingWheel.Schedule(startTick + BoundaryDelays[delayIndex], delayIndex);
+		}
+
+		TestEqual(TEXT("Every timer is pending"), timingWheel.Num(), static_cast<int32>(UE_ARRAY_COUNT(BoundaryDelays)));
+
+		for (int32 delayIndex = 0; delayIndex < UE_ARRAY_COUNT(BoundaryDelays); ++delayIndex)
+		{
+			if (!ExpiresAt(*this, timingWheel, startTick + BoundaryDelays[delayIndex], delayIndex))
+			{
+				AddError(FString::Printf(TEXT("Timer %llu ticks after tick %llu did not expire on time"), BoundaryDelays[delayIndex], startTick));
+				break;
+			}
+		}
+
+		TestEqual(TEXT("No timer is left"), timingWheel.Num(), 0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTimingWheelOrderTest, "GCInventory.TimingWheel.ExpirationOrder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCTimingWheelOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace GCTimingWheelTests;
+
+	FGCTimingWheel timingWheel;
+
+	// scheduled out of order over every level, then expired by a single advance
+	TArray<uint64> expireTicks;
+	for (int32 timerIndex = 0; timerIndex < 256; ++timerIndex)
+	{
+		expireTicks.Add(1 + (uint64(timerIndex) * 7919 * 104729) % (LevelSpan3 * 2));
+	}
+
+	for (int32 timerIndex = 0; timerIndex < expireTicks.Num(); ++timerIndex)
+	{
+		timingWheel.Schedule(expireTicks[timerIndex], timerIndex);
+	}
+
+	TArray<int32> expiredPayloads;
+	timingWheel.Advance(LevelSpan3 * 2, expiredPayloads);
+
+	if (TestEqual(TEXT("Every timer expired"), expiredPayloads.Num(), expireTicks.Num()))
+	{
+		for (int32 expiredIndex = 1; expiredIndex < expiredPayloads.Num(); ++expiredIndex)
+		{
+			if (expireTicks[expiredPayloads[expiredIndex - 1]] > expireTicks[expiredPayloads[expiredIndex]])
+			{
+				AddError(FString::Printf(TEXT("Timer due at %llu expired after the timer due at %llu"), expireTicks[expiredPayloads[expiredIndex - 1]], expireTicks[expiredPayloads[expiredIndex]]));
+				break;
+			}
+		}
+	}
+
+	// a tick that already went by expires on the next one
+	const int32 lateTimer = timingWheel.Schedule(10, 1000);
+	TestTrue(TEXT("The late timer is valid"), lateTimer != INDEX_NONE);
+	ExpiresAt(*this, timingWheel, LevelSpan3 * 2 + 1, 1000);
+
+	// timers sharing a tick all expire in it
+	timingWheel.Schedule(LevelSpan3 * 3, 1);
+	timingWheel.Schedule(LevelSpan3 * 3, 2);
+	timingWheel.Schedule(LevelSpan3 * 3, 3);
+
+	expiredPayloads.Reset();
+	timingWheel.Advance(LevelSpan3 * 3, expiredPayloads);
+	expiredPayloads.Sort();
+	TestEqual(TEXT("Timers sharing a tick expire together"), expiredPayloads, TArray<int32>({ 1, 2, 3 }));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCTimingWheelCancelTest, "GCInventory.TimingWheel.CancelAndReuse", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGCTimingWheelCancelTest::RunTest(const FString& Parameters)
+{
+	using namespace GCTimingWheelTests;
+
+	FGCTimingWheel timingWheel;
+	TArray<int32> expiredPayloads;
+
+	// cancelled once their level was spread into the level below
+	const uint64 levelOneExpireTick = LevelSpan2 + 10;
+	const uint64 levelTwoExpireTick = LevelSpan3 + LevelSpan1 * 3 + 10;
+	const uint64 parkedExpireTick = WheelSpan + LevelSpan2 + 10;
+
+	const int32 levelOneTimer = timingWheel.Schedule(levelOneExpireTick, 1);
+	const int32 levelTwoTimer = timingWheel.Schedule(levelTwoExpireTick, 2);
+	const int32 parkedTimer = timingWheel.Schedule(parkedExpireTick, 3);
+	const int32 keptTimer = timingWheel.Schedule(parkedExpireTick + 1, 4);
+
+	timingWheel.Advance(levelOneExpireTick - 5, expiredPayloads);
+	timingWheel.Cancel(levelOneTimer);
+
+	timingWheel.Advance(levelTwoExpireTick - 5, expiredPayloads);
+	timingWheel.Cancel(levelTwoTimer);
+
+	timingWheel.Advance(parkedExpireTick - 5, expiredPayloads);
+	timingWheel.Cancel(parkedTimer);
+
+	TestEqual(TEXT("Only the kept timer is pending"), timingWheel.Num(), 1);
+
+	timingWheel.Advance(parkedExpireTick + LevelSpan1, expiredPayloads);
+	TestEqual(TEXT("Only the kept timer expired"), expiredPayloads, TArray<int32>({ 4 }));
+
+	// cancelling an expired or cancelled timer does nothing
+	timingWheel.Cancel(keptTimer);
+	timingWheel.Cancel(levelOneTimer);
+	TestEqual(TEXT("No timer is pending"), timingWheel.Num(), 0);
+
+	// freed timers are reused and behave like new ones
+	const int32 reusedTimer = timingWheel.Schedule(timingWheel.GetCurrentTick() + LevelSpan1 + 1, 5);
+	TestTrue(TEXT("A freed timer is reused"), reusedTimer == levelOneTimer || reusedTimer == levelTwoTimer || reusedTimer == parkedTimer || reusedTimer == keptTimer);
+
+	const int32 cancelledTimer = timingWheel.Schedule(timingWheel.GetCurrentTick() + LevelSpan1 + 1, 6);
+	timingWheel.Cancel(cancelledTimer);
+
+	ExpiresAt(*this, timingWheel, timingWheel.GetCurrentTick() + LevelSpan1 + 1, 5);
+	TestEqual(TEXT("No timer is left"), timingWheel.Num(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS